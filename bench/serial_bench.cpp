@@ -0,0 +1,718 @@
+/*
+* Loopback benchmark of the serial library.
+*
+* Every port is the slave side of an `openpty` pair, a peer thread on the
+* master side plays the device. No hardware is needed, so the benchmark runs
+* on any Linux machine. It reports the throughput of read and write for a
+* matrix of chunk sizes and port counts, and the round trip latency of
+* write + readUntil for a matrix of delimiter lengths and port counts.
+* Finally many protocol sessions run as coroutines on a single event loop
+* and report their round trip latency the same way.
+*
+* The received bytes are checked against the sent pattern, so a run also
+* fails (exit code 1) if the library loses, duplicates or reorders bytes.
+*
+* Usage: serial_bench [--quick] [--engine blocking|reactor|io_uring|buffered]
+*/
+#include <pty.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "serial.h"
+#include "engines.h"
+#include "serial_port.h"
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    // Time a peer or the library may stay silent before a run counts as stalled
+    constexpr int stallTimeout = 2000;
+
+    struct Settings {
+        std::size_t throughputBytes;
+        int roundTrips;
+        std::vector<int> chunkSizes;
+        std::vector<int> portCounts;
+        std::vector<std::string> delimiters;
+        std::vector<Engines> engines;
+        std::vector<int> sessionCounts;
+    };
+
+    struct Loopback {
+        int master{-1};
+        int slave{-1};
+        int handle{0};
+    };
+
+    auto engineName(const Engines engine) -> const char* {
+        switch (engine) {
+            case Engines::BLOCKING: return "blocking";
+            case Engines::REACTOR: return "reactor";
+            case Engines::IO_URING: return "io_uring";
+            case Engines::BUFFERED: return "buffered";
+        }
+
+        return "unknown";
+    }
+
+    // Byte at the given offset of the stream the throughput runs send
+    auto patternByte(const std::size_t offset) -> char {
+        return static_cast<char>((offset * 131 + (offset >> 8)) & 0xFF);
+    }
+
+    /**
+    * @brief Opens the pseudo terminal pairs and the library ports on their slave sides.
+    * @return Returns `false` if the engine is not available on this machine
+    */
+    auto openLoopbacks(const int count, const Engines engine, std::vector<Loopback> &loopbacks) -> bool {
+        loopbacks.resize(static_cast<std::size_t>(count));
+
+        for (Loopback &loopback : loopbacks) {
+            char name[128];
+
+            if (openpty(&loopback.master, &loopback.slave, name, nullptr, nullptr) < 0) {
+                perror("openpty");
+                return false;
+            }
+
+            loopback.handle = serialOpen(name, 115200, 8, 0, 0, static_cast<int>(engine), 0);
+
+            if (loopback.handle < 0) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    auto closeLoopbacks(std::vector<Loopback> &loopbacks) -> void {
+        for (Loopback &loopback : loopbacks) {
+            if (loopback.handle > 0) {
+                serialClose(loopback.handle);
+            }
+            if (loopback.slave >= 0) {
+                ::close(loopback.slave);
+            }
+            if (loopback.master >= 0) {
+                ::close(loopback.master);
+            }
+        }
+
+        loopbacks.clear();
+    }
+
+    /**
+    * @brief Writes the whole buffer to the master side, giving up once the slave side stalls.
+    */
+    auto writeAll(const int fd, const char* data, std::size_t size) -> bool {
+        while (size > 0) {
+            pollfd descriptor{fd, POLLOUT, 0};
+            if (poll(&descriptor, 1, stallTimeout) <= 0) {
+                return false;
+            }
+
+            const ssize_t result = ::write(fd, data, size);
+
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+            if (result <= 0) {
+                return false;
+            }
+
+            data += result;
+            size -= static_cast<std::size_t>(result);
+        }
+
+        return true;
+    }
+
+    /**
+    * @brief Moves the pattern from the peers to the library, every port reads `bytes` in reads of `chunkSize`.
+    * @return Returns the throughput in MB/s over all ports or a negative value if a port lost data
+    */
+    auto measureRead(std::vector<Loopback> &loopbacks, const std::size_t bytes, const int chunkSize) -> double {
+        std::atomic<bool> failed{false};
+        std::vector<std::thread> threads;
+
+        const auto start = Clock::now();
+
+        for (Loopback &loopback : loopbacks) {
+            // Peer: sends the pattern
+            threads.emplace_back([&loopback, bytes, &failed] {
+                std::vector<char> data(4096);
+
+                for (std::size_t offset = 0; offset < bytes && !failed;) {
+                    const std::size_t size = std::min(data.size(), bytes - offset);
+
+                    for (std::size_t i = 0; i < size; i++) {
+                        data[i] = patternByte(offset + i);
+                    }
+
+                    if (!writeAll(loopback.master, data.data(), size)) {
+                        failed = true;
+                    }
+
+                    offset += size;
+                }
+            });
+
+            // Library: reads and checks the pattern
+            threads.emplace_back([&loopback, bytes, chunkSize, &failed] {
+                std::vector<char> buffer(static_cast<std::size_t>(chunkSize));
+                std::size_t received = 0;
+                auto lastProgress = Clock::now();
+
+                while (received < bytes && !failed) {
+                    const int result = serialRead(loopback.handle, buffer.data(), chunkSize, 100, 0);
+
+                    if (result < 0) {
+                        failed = true;
+                        break;
+                    }
+
+                    if (result == 0) {
+                        if (Clock::now() - lastProgress > std::chrono::milliseconds(stallTimeout)) {
+                            failed = true;
+                        }
+                        continue;
+                    }
+
+                    for (int i = 0; i < result; i++) {
+                        if (buffer[static_cast<std::size_t>(i)] != patternByte(received + static_cast<std::size_t>(i))) {
+                            failed = true;
+                            break;
+                        }
+                    }
+
+                    received += static_cast<std::size_t>(result);
+                    lastProgress = Clock::now();
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        return failed ? -1.0 : static_cast<double>(bytes * loopbacks.size()) / seconds / 1e6;
+    }
+
+    /**
+    * @brief Moves the pattern from the library to the peers, every port writes `bytes` in writes of `chunkSize`.
+    * @return Returns the throughput in MB/s over all ports or a negative value if a peer lost data
+    */
+    auto measureWrite(std::vector<Loopback> &loopbacks, const std::size_t bytes, const int chunkSize) -> double {
+        std::atomic<bool> failed{false};
+        std::vector<std::thread> threads;
+
+        const auto start = Clock::now();
+
+        for (Loopback &loopback : loopbacks) {
+            // Library: sends the pattern
+            threads.emplace_back([&loopback, bytes, chunkSize, &failed] {
+                std::vector<char> data(static_cast<std::size_t>(chunkSize));
+
+                for (std::size_t offset = 0; offset < bytes && !failed;) {
+                    const std::size_t size = std::min(data.size(), bytes - offset);
+
+                    for (std::size_t i = 0; i < size; i++) {
+                        data[i] = patternByte(offset + i);
+                    }
+
+                    const int result = serialWrite(loopback.handle, data.data(), static_cast<int>(size), stallTimeout, 0);
+
+                    if (result <= 0) {
+                        failed = true;
+                        break;
+                    }
+
+                    offset += static_cast<std::size_t>(result);
+                }
+            });
+
+            // Peer: drains and checks the pattern
+            threads.emplace_back([&loopback, bytes, &failed] {
+                std::vector<char> buffer(4096);
+                std::size_t received = 0;
+
+                while (received < bytes && !failed) {
+                    pollfd descriptor{loopback.master, POLLIN, 0};
+                    if (poll(&descriptor, 1, stallTimeout) <= 0) {
+                        failed = true;
+                        break;
+                    }
+
+                    const ssize_t result = ::read(loopback.master, buffer.data(), buffer.size());
+
+                    if (result <= 0) {
+                        failed = true;
+                        break;
+                    }
+
+                    for (ssize_t i = 0; i < result; i++) {
+                        if (buffer[static_cast<std::size_t>(i)] != patternByte(received + static_cast<std::size_t>(i))) {
+                            failed = true;
+                            break;
+                        }
+                    }
+
+                    received += static_cast<std::size_t>(result);
+                }
+            });
+        }
+
+        for (std::thread &thread : threads) {
+            thread.join();
+        }
+
+        const double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+        return failed ? -1.0 : static_cast<double>(bytes * loopbacks.size()) / seconds / 1e6;
+    }
+
+    /**
+    * @brief Sends frames that end with the delimiter, the peers echo them and the library reads them back with readUntil.
+    * @return Returns the round trip times in `us` of every port or an empty list if a frame came back wrong
+    */
+    auto measureRoundTrips(std::vector<Loopback> &loopbacks, const int roundTrips, const std::string &delimiter) -> std::vector<double> {
+        std::atomic<bool> failed{false};
+        std::atomic<bool> stopping{false};
+        std::vector<std::thread> peers;
+        std::vector<std::thread> clients;
+        std::vector<std::vector<double>> samples(loopbacks.size());
+
+        // Lower case letters never collide with the delimiters of the matrix
+        std::string frame;
+        for (int i = 0; i < 32; i++) {
+            frame += static_cast<char>('a' + i % 26);
+        }
+        frame += delimiter;
+
+        for (std::size_t port = 0; port < loopbacks.size(); port++) {
+            Loopback &loopback = loopbacks[port];
+
+            // Peer: echoes whatever it receives
+            peers.emplace_back([&loopback, &stopping, &failed] {
+                char buffer[4096];
+
+                while (!stopping) {
+                    pollfd descriptor{loopback.master, POLLIN, 0};
+                    if (poll(&descriptor, 1, 50) <= 0) {
+                        continue;
+                    }
+
+                    const ssize_t result = ::read(loopback.master, buffer, sizeof(buffer));
+
+                    if (result <= 0 || !writeAll(loopback.master, buffer, static_cast<std::size_t>(result))) {
+                        failed = true;
+                        return;
+                    }
+                }
+            });
+
+            // Library: writes a frame and waits for its echo
+            clients.emplace_back([&loopback, &samples, port, roundTrips, &frame, &delimiter, &failed] {
+                std::vector<char> response(frame.size() + 1);
+
+                for (int i = 0; i < roundTrips && !failed; i++) {
+                    const auto start = Clock::now();
+
+                    if (serialWrite(loopback.handle, frame.data(), static_cast<int>(frame.size()), stallTimeout, 0) != static_cast<int>(frame.size())) {
+                        failed = true;
+                        break;
+                    }
+
+                    std::size_t received = 0;
+
+                    while (received < frame.size()) {
+                        const int result = serialReadUntil(
+                            loopback.handle,
+                            response.data() + received,
+                            static_cast<int>(response.size() - received),
+                            stallTimeout,
+                            0,
+                            const_cast<char*>(delimiter.c_str())
+                        );
+
+                        if (result <= 0) {
+                            failed = true;
+                            break;
+                        }
+
+                        received += static_cast<std::size_t>(result);
+                    }
+
+                    if (failed || memcmp(response.data(), frame.data(), frame.size()) != 0) {
+                        failed = true;
+                        break;
+                    }
+
+                    samples[port].push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+                }
+            });
+        }
+
+        for (std::thread &client : clients) {
+            client.join();
+        }
+
+        stopping = true;
+
+        for (std::thread &peer : peers) {
+            peer.join();
+        }
+
+        std::vector<double> all;
+
+        if (failed) {
+            return all;
+        }
+
+        for (const std::vector<double> &portSamples : samples) {
+            all.insert(all.end(), portSamples.begin(), portSamples.end());
+        }
+
+        std::sort(all.begin(), all.end());
+
+        return all;
+    }
+
+    auto percentile(const std::vector<double> &sorted, const double fraction) -> double {
+        const std::size_t index = static_cast<std::size_t>(fraction * static_cast<double>(sorted.size() - 1));
+        return sorted[index];
+    }
+
+    auto delimiterName(const std::string &delimiter) -> std::string {
+        std::string name;
+
+        for (const char c : delimiter) {
+            name += c == '\n' ? "\\n" : c == '\r' ? "\\r" : std::string(1, c);
+        }
+
+        return name;
+    }
+
+    /**
+    * @brief Writes the frame and reads its echo until the delimiter, `roundTrips` times, as a coroutine.
+    * The last session that ends stops the loop.
+    */
+    auto runSession(
+        serial::Port &port,
+        serial::EventLoop &loop,
+        const std::string &frame,
+        const int roundTrips,
+        std::vector<double> &samples,
+        bool &failed,
+        int &running
+    ) -> serial::Task<void> {
+        std::vector<char> response(frame.size() + 1);
+
+        for (int i = 0; i < roundTrips && !failed; i++) {
+            const auto start = Clock::now();
+
+            const serial::Result<std::size_t> result = co_await port.transact(
+                std::as_bytes(std::span(frame)),
+                std::as_writable_bytes(std::span(response)),
+                "\n",
+                stallTimeout
+            );
+
+            if (result.value_or(0) != frame.size() || memcmp(response.data(), frame.data(), frame.size()) != 0) {
+                failed = true;
+                break;
+            }
+
+            samples.push_back(std::chrono::duration<double, std::micro>(Clock::now() - start).count());
+        }
+
+        if (--running == 0) {
+            loop.stop();
+        }
+    }
+
+    /**
+    * @brief Runs one session per port on a single event loop, one peer thread echoes the frames of all of them.
+    * @param heapFrames Receives the number of coroutine frames per port that had to come from the heap
+    * @return Returns the round trip times in `us` of every session or an empty list if a frame came back wrong
+    */
+    auto measureSessions(const int sessions, const int roundTrips, double &heapFrames) -> std::vector<double> {
+        serial::EventLoop loop;
+        std::vector<serial::Port> ports;
+        std::vector<pollfd> masters;
+        std::vector<std::vector<double>> samples(static_cast<std::size_t>(sessions));
+        std::atomic<bool> stopping{false};
+        std::atomic<bool> peerFailed{false};
+        bool failed = false;
+
+        ports.reserve(static_cast<std::size_t>(sessions));
+
+        for (int i = 0; i < sessions && !failed; i++) {
+            int master;
+            int slave;
+            char name[128];
+
+            if (openpty(&master, &slave, name, nullptr, nullptr) < 0) {
+                perror("openpty");
+                failed = true;
+                break;
+            }
+
+            serial::Result<serial::Port> port = serial::Port::open(loop, name, 115200);
+
+            masters.push_back({master, POLLIN, 0});
+            ::close(slave);
+
+            if (!port) {
+                failed = true;
+                break;
+            }
+
+            ports.push_back(std::move(*port));
+        }
+
+        // Peer: echoes whatever any of the sessions sends
+        std::thread peer([&masters, &stopping, &peerFailed] {
+            char buffer[4096];
+
+            while (!stopping) {
+                if (poll(masters.data(), masters.size(), 50) <= 0) {
+                    continue;
+                }
+
+                for (const pollfd &master : masters) {
+                    if (!(master.revents & POLLIN)) {
+                        continue;
+                    }
+
+                    const ssize_t result = ::read(master.fd, buffer, sizeof(buffer));
+
+                    if (result <= 0 || !writeAll(master.fd, buffer, static_cast<std::size_t>(result))) {
+                        peerFailed = true;
+                        return;
+                    }
+                }
+            }
+        });
+
+        // Lower case letters never collide with the delimiter
+        std::string frame;
+        for (int i = 0; i < 32; i++) {
+            frame += static_cast<char>('a' + i % 26);
+        }
+        frame += "\n";
+
+        if (!failed) {
+            int running = sessions;
+
+            for (std::size_t i = 0; i < ports.size(); i++) {
+                loop.spawn(runSession(ports[i], loop, frame, roundTrips, samples[i], failed, running));
+            }
+
+            loop.run();
+        }
+
+        heapFrames = 0;
+
+        for (serial::Port &port : ports) {
+            heapFrames += static_cast<double>(port.framePool()->allocations()) / static_cast<double>(ports.size());
+        }
+
+        ports.clear();
+        stopping = true;
+        peer.join();
+
+        for (const pollfd &master : masters) {
+            ::close(master.fd);
+        }
+
+        std::vector<double> all;
+
+        if (failed || peerFailed) {
+            return all;
+        }
+
+        for (const std::vector<double> &sessionSamples : samples) {
+            all.insert(all.end(), sessionSamples.begin(), sessionSamples.end());
+        }
+
+        std::sort(all.begin(), all.end());
+
+        return all;
+    }
+
+    /**
+    * @brief Runs the whole matrix for one engine.
+    * @return Returns `false` if any run lost data
+    */
+    auto runEngine(const Engines engine, const Settings &settings) -> bool {
+        bool passed = true;
+        std::vector<Loopback> loopbacks;
+
+        printf("engine %s\n", engineName(engine));
+
+        if (!openLoopbacks(1, engine, loopbacks)) {
+            printf("  not available, skipped\n");
+            closeLoopbacks(loopbacks);
+            return true;
+        }
+        closeLoopbacks(loopbacks);
+
+        for (const int ports : settings.portCounts) {
+            for (const int chunkSize : settings.chunkSizes) {
+                for (const bool reading : {true, false}) {
+                    if (!openLoopbacks(ports, engine, loopbacks)) {
+                        printf("  open of %d ports failed\n", ports);
+                        closeLoopbacks(loopbacks);
+                        return false;
+                    }
+
+                    const double throughput = reading
+                        ? measureRead(loopbacks, settings.throughputBytes, chunkSize)
+                        : measureWrite(loopbacks, settings.throughputBytes, chunkSize);
+
+                    closeLoopbacks(loopbacks);
+
+                    if (throughput < 0) {
+                        printf("  throughput %-5s ports=%-3d chunk=%-6d FAILED\n", reading ? "read" : "write", ports, chunkSize);
+                        passed = false;
+                        continue;
+                    }
+
+                    printf("  throughput %-5s ports=%-3d chunk=%-6d %10.2f MB/s\n", reading ? "read" : "write", ports, chunkSize, throughput);
+                }
+            }
+        }
+
+        for (const int ports : settings.portCounts) {
+            for (const std::string &delimiter : settings.delimiters) {
+                if (!openLoopbacks(ports, engine, loopbacks)) {
+                    printf("  open of %d ports failed\n", ports);
+                    closeLoopbacks(loopbacks);
+                    return false;
+                }
+
+                const std::vector<double> samples = measureRoundTrips(loopbacks, settings.roundTrips, delimiter);
+
+                closeLoopbacks(loopbacks);
+
+                if (samples.empty()) {
+                    printf("  latency    ports=%-3d delimiter=%-10s FAILED\n", ports, delimiterName(delimiter).c_str());
+                    passed = false;
+                    continue;
+                }
+
+                printf(
+                    "  latency    ports=%-3d delimiter=%-10s p50=%9.1fus p90=%9.1fus p99=%9.1fus max=%9.1fus\n",
+                    ports,
+                    delimiterName(delimiter).c_str(),
+                    percentile(samples, 0.50),
+                    percentile(samples, 0.90),
+                    percentile(samples, 0.99),
+                    samples.back()
+                );
+            }
+        }
+
+        return passed;
+    }
+
+    /**
+    * @brief Runs the coroutine sessions for every session count.
+    * @return Returns `false` if any session got a frame back wrong
+    */
+    auto runSessions(const Settings &settings) -> bool {
+        bool passed = true;
+
+        printf("coroutine sessions\n");
+
+        for (const int sessions : settings.sessionCounts) {
+            double heapFrames = 0;
+            const std::vector<double> samples = measureSessions(sessions, settings.roundTrips, heapFrames);
+
+            if (samples.empty()) {
+                printf("  latency    sessions=%-5d FAILED\n", sessions);
+                passed = false;
+                continue;
+            }
+
+            printf(
+                "  latency    sessions=%-5d p50=%9.1fus p90=%9.1fus p99=%9.1fus max=%9.1fus heap frames/port=%.1f\n",
+                sessions,
+                percentile(samples, 0.50),
+                percentile(samples, 0.90),
+                percentile(samples, 0.99),
+                samples.back(),
+                heapFrames
+            );
+        }
+
+        return passed;
+    }
+}
+
+auto main(int argc, char** argv) -> int {
+    Settings settings{
+        4 * 1024 * 1024,
+        2000,
+        {1, 16, 256, 4096, 65536},
+        {1, 4, 16},
+        {"\n", "\r\n", "#END", "--frame-end--"},
+        {Engines::BLOCKING, Engines::REACTOR, Engines::IO_URING, Engines::BUFFERED},
+        {1, 64, 256}
+    };
+
+    for (int i = 1; i < argc; i++) {
+        const std::string argument = argv[i];
+
+        if (argument == "--quick") {
+            settings.throughputBytes = 256 * 1024;
+            settings.roundTrips = 100;
+            settings.chunkSizes = {16, 4096};
+            settings.portCounts = {1, 4};
+            settings.delimiters = {"\n", "#END"};
+            settings.sessionCounts = {16, 256};
+        } else if (argument == "--engine" && i + 1 < argc) {
+            const std::string name = argv[++i];
+            settings.engines.clear();
+
+            for (const Engines engine : {Engines::BLOCKING, Engines::REACTOR, Engines::IO_URING, Engines::BUFFERED}) {
+                if (name == engineName(engine)) {
+                    settings.engines.push_back(engine);
+                }
+            }
+
+            if (settings.engines.empty()) {
+                fprintf(stderr, "unknown engine %s\n", name.c_str());
+                return 2;
+            }
+        } else {
+            fprintf(stderr, "usage: %s [--quick] [--engine blocking|reactor|io_uring|buffered]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    bool passed = true;
+
+    for (const Engines engine : settings.engines) {
+        passed = runEngine(engine, settings) && passed;
+    }
+
+    passed = runSessions(settings) && passed;
+
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstddef>
+
+/**
+* @brief Finds the first occurrence of the byte, vectorized with AVX2, SSE2 or NEON where available.
+* @return Returns the index of the byte or `size` if it does not occur
+*/
+auto findByte(const char* data, std::size_t size, char byte) -> std::size_t;
+
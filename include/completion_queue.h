@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "serial.h"
+
+/**
+* @brief Runs submitted port operations on worker threads and collects their results.
+*
+* Every port gets one worker for its reads and one for its writes. Reads of a
+* port complete in the order they were submitted and so do its writes, while a
+* read that waits for bytes never holds up a write and different ports never
+* wait for each other. A worker exits after it has been idle for a while and is
+* started again by the next submission. Finished operations are queued until a caller picks
+* them up in batches with `wait`. A submission is refused while too many operations are
+* queued, running or waiting to be picked up, so a caller that stops waiting can not grow the
+* queue without bound.
+*/
+class CompletionQueue {
+public:
+    using Operation = std::function<int()>;
+
+    enum class Lane {
+        READ,
+        WRITE
+    };
+
+    /**
+    * @brief Returns the process wide completion queue.
+    */
+    static auto instance() -> CompletionQueue&;
+
+    /**
+    * @brief Queues the operation on the worker of the port that runs the operations of the lane.
+    * @return Returns `false` if too many operations have not been picked up yet, the operation is then dropped
+    */
+    auto submit(int handle, Lane lane, std::uint32_t requestId, Operation operation) -> bool;
+
+    /**
+    * @brief Waits until at least one request has completed or the timeout expires and moves up to `maxCompletions` completions out.
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever
+    * @return Returns the number of completions written
+    */
+    auto wait(Completion* completions, int maxCompletions, int timeout) -> int;
+
+private:
+    struct Request {
+        std::uint32_t requestId;
+        Operation operation;
+    };
+
+    struct Worker {
+        std::deque<Request> requests;
+        // Each worker waits on its own, so a submission wakes only the worker of its port and lane
+        std::condition_variable ready;
+        bool running{false};
+    };
+
+    using WorkerKey = std::pair<int, Lane>;
+
+    CompletionQueue() = default;
+
+    auto work(WorkerKey key) -> void;
+
+    std::mutex workerMutex;
+    std::map<WorkerKey, Worker> workers;
+
+    std::mutex completionMutex;
+    std::condition_variable completionReady;
+    std::vector<Completion> completions;
+    // Operations submitted and not picked up by `wait` yet
+    std::size_t outstanding{0};
+};
@@ -0,0 +1,264 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "frame_pool.h"
+
+namespace serial {
+
+    class EventLoop;
+
+    template <typename T>
+    class Task;
+
+    /**
+    * @brief A port or a pointer to one, whose `framePool` the coroutine frames can be taken from.
+    */
+    template <typename Owner>
+    concept FrameOwner = requires(const Owner &owner) { owner.framePool(); }
+        || requires(const Owner &owner) { owner->framePool(); };
+
+    template <FrameOwner Owner>
+    auto framePoolOf(const Owner &owner) -> FramePool* {
+        if constexpr (requires { owner.framePool(); }) {
+            return owner.framePool();
+        } else {
+            return owner ? owner->framePool() : nullptr;
+        }
+    }
+
+    /**
+    * @brief The part of the promise of a `Task` that does not depend on its result.
+    *
+    * A task starts suspended and runs once it is awaited, handed to `EventLoop::run`
+    * or spawned. When it finishes it resumes its awaiter right away through symmetric
+    * transfer, so a chain of awaited tasks does not grow the stack.
+    *
+    * The frame of a coroutine whose first parameter is a port, or a pointer to one,
+    * comes from the frame pool of that port (see `PooledTaskPromise`). Every other
+    * frame comes from the heap.
+    */
+    class TaskPromiseBase {
+    public:
+        struct FinalAwaiter {
+            auto await_ready() const noexcept -> bool {
+                return false;
+            }
+
+            template <typename Promise>
+            auto await_suspend(std::coroutine_handle<Promise> handle) noexcept -> std::coroutine_handle<> {
+                TaskPromiseBase &promise = handle.promise();
+
+                if (promise.continuation) {
+                    return promise.continuation;
+                }
+
+                // A spawned task has no owner that could report its exception
+                if (promise.detached) {
+                    if (promise.exception) {
+                        std::terminate();
+                    }
+
+                    handle.destroy();
+                }
+
+                return std::noop_coroutine();
+            }
+
+            auto await_resume() const noexcept -> void {}
+        };
+
+        auto initial_suspend() const noexcept -> std::suspend_always {
+            return {};
+        }
+
+        auto final_suspend() const noexcept -> FinalAwaiter {
+            return {};
+        }
+
+        auto unhandled_exception() noexcept -> void {
+            exception = std::current_exception();
+        }
+
+        static auto operator new(const std::size_t size) -> void* {
+            return FramePool::allocate(nullptr, size);
+        }
+
+        static auto operator delete(void* frame, std::size_t) noexcept -> void {
+            FramePool::deallocate(frame);
+        }
+
+        std::coroutine_handle<> continuation;
+        std::exception_ptr exception;
+        bool detached{false};
+    };
+
+    template <typename T>
+    class TaskPromise : public TaskPromiseBase {
+    public:
+        auto get_return_object() -> Task<T>;
+
+        template <typename Value>
+        auto return_value(Value &&result) -> void {
+            value.emplace(std::forward<Value>(result));
+        }
+
+        auto result() -> T {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+
+            return std::move(*value);
+        }
+
+    private:
+        std::optional<T> value;
+    };
+
+    template <>
+    class TaskPromise<void> : public TaskPromiseBase {
+    public:
+        auto get_return_object() -> Task<void>;
+
+        auto return_void() const noexcept -> void {}
+
+        auto result() -> void {
+            if (exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+    };
+
+    /**
+    * @brief Lazily started coroutine that produces a `T`, awaiting it runs it to completion.
+    * Destroying a task that has not finished destroys its frame without resuming it.
+    */
+    template <typename T = void>
+    class [[nodiscard]] Task {
+    public:
+        using promise_type = TaskPromise<T>;
+
+        Task() = default;
+
+        // The handle is the one of the promise that was created, which may derive from `promise_type`
+        Task(const std::coroutine_handle<> coroutine, promise_type &promise) : coroutine(coroutine), promise(&promise) {}
+
+        Task(Task &&other) noexcept :
+            coroutine(std::exchange(other.coroutine, {})),
+            promise(std::exchange(other.promise, nullptr)) {}
+
+        auto operator=(Task &&other) noexcept -> Task& {
+            if (this != &other) {
+                if (coroutine) {
+                    coroutine.destroy();
+                }
+
+                coroutine = std::exchange(other.coroutine, {});
+                promise = std::exchange(other.promise, nullptr);
+            }
+
+            return *this;
+        }
+
+        Task(const Task&) = delete;
+        auto operator=(const Task&) -> Task& = delete;
+
+        ~Task() {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+        }
+
+        /**
+        * @brief Returns `true` if the task has finished or holds no coroutine.
+        */
+        auto done() const -> bool {
+            return !coroutine || coroutine.done();
+        }
+
+        auto operator co_await() const noexcept {
+            struct Awaiter {
+                std::coroutine_handle<> coroutine;
+                promise_type* promise;
+
+                auto await_ready() const noexcept -> bool {
+                    return !coroutine || coroutine.done();
+                }
+
+                auto await_suspend(const std::coroutine_handle<> awaiter) noexcept -> std::coroutine_handle<> {
+                    promise->continuation = awaiter;
+                    return coroutine;
+                }
+
+                auto await_resume() -> T {
+                    return promise->result();
+                }
+            };
+
+            return Awaiter{coroutine, promise};
+        }
+
+    private:
+        friend class EventLoop;
+
+        std::coroutine_handle<> coroutine;
+        promise_type* promise{nullptr};
+    };
+
+    /**
+    * @brief Promise of a task whose first parameter is a `FrameOwner`, chosen by `std::coroutine_traits`.
+    *
+    * The allocation functions are members of the promise of one signature
+    * instead of templates of a shared promise, so that a compiler checking
+    * which `operator delete` frees the memory of which `operator new` sees a
+    * matching pair.
+    */
+    template <typename T, typename Owner, typename... Args>
+    class PooledTaskPromise : public TaskPromise<T> {
+    public:
+        auto get_return_object() -> Task<T> {
+            return Task<T>(std::coroutine_handle<PooledTaskPromise>::from_promise(*this), *this);
+        }
+
+        static auto operator new(
+            const std::size_t size,
+            const std::remove_reference_t<Owner> &owner,
+            const std::remove_reference_t<Args>&...
+        ) -> void* {
+            return FramePool::allocate(framePoolOf(owner), size);
+        }
+
+        static auto operator delete(void* frame, std::size_t) noexcept -> void {
+            FramePool::deallocate(frame);
+        }
+
+        // Frees the frame if the parameters can not be copied into it, every frame knows the pool it came from
+        static auto operator delete(
+            void* frame,
+            const std::remove_reference_t<Owner>&,
+            const std::remove_reference_t<Args>&...
+        ) noexcept -> void {
+            FramePool::deallocate(frame);
+        }
+    };
+
+    template <typename T>
+    auto TaskPromise<T>::get_return_object() -> Task<T> {
+        return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this), *this);
+    }
+
+    inline auto TaskPromise<void>::get_return_object() -> Task<void> {
+        return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this), *this);
+    }
+}
+
+template <typename T, typename Owner, typename... Args>
+    requires serial::FrameOwner<std::remove_cvref_t<Owner>>
+struct std::coroutine_traits<serial::Task<T>, Owner, Args...> {
+    using promise_type = serial::PooledTaskPromise<T, Owner, Args...>;
+};
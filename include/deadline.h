@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+
+/**
+* @brief Absolute deadline of a call, the `COMMTIMEOUTS` semantics of the Windows backend on a monotonic clock.
+*
+* A call may last `timeout + multiplier * bytes` milliseconds in total. Once
+* bytes arrived, a gap of more than `timeout` milliseconds until the next ones
+* also ends it. Reads without any timeout only take what is already there,
+* writes without any timeout wait until everything is written.
+*/
+class Deadline {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static auto forRead(const int timeout, const int multiplier, const int bytes) -> Deadline {
+        return Deadline(timeout, multiplier, bytes, false);
+    }
+
+    static auto forWrite(const int timeout, const int multiplier, const int bytes) -> Deadline {
+        return Deadline(timeout, multiplier, bytes, true);
+    }
+
+    /**
+    * @brief Returns the milliseconds the next wait may last, `0` once the deadline has passed or `-1` if there is none.
+    */
+    auto remaining() const -> int {
+        if (total == Clock::time_point::max()) {
+            return -1;
+        }
+
+        const auto now = Clock::now();
+        const auto end = progressed && interval.count() > 0 ? std::min(total, lastProgress + interval) : total;
+
+        if (end <= now) {
+            return 0;
+        }
+
+        return static_cast<int>(std::chrono::ceil<std::chrono::milliseconds>(end - now).count());
+    }
+
+    auto expired() const -> bool {
+        return remaining() == 0;
+    }
+
+    /**
+    * @brief Notes that bytes were transferred, which starts the interval until the next ones.
+    */
+    auto progress() -> void {
+        progressed = true;
+        lastProgress = Clock::now();
+    }
+
+private:
+    Deadline(const int timeout, const int multiplier, const int bytes, const bool unboundedIfZero) {
+        const long long milliseconds = std::max(0LL, static_cast<long long>(timeout) + static_cast<long long>(multiplier) * std::max(bytes, 0));
+
+        interval = std::chrono::milliseconds(std::max(timeout, 0));
+        total = milliseconds == 0 && unboundedIfZero
+            ? Clock::time_point::max()
+            : Clock::now() + std::chrono::milliseconds(milliseconds);
+    }
+
+    Clock::time_point total;
+    Clock::time_point lastProgress;
+    std::chrono::milliseconds interval{0};
+    bool progressed{false};
+};
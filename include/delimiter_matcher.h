@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "byte_search.h"
+
+/**
+* @brief Precompiled Knuth-Morris-Pratt automaton for a multi byte delimiter.
+*
+* The matcher is fed the received bytes chunk by chunk and keeps the length of
+* the partial match between calls, so a delimiter that straddles two reads is
+* found without rescanning anything. While no partial match is pending, it
+* jumps to the next occurrence of the first delimiter byte with `findByte`.
+*
+* Ports cache their matcher, `compile` only rebuilds it when the delimiter changes.
+*/
+class DelimiterMatcher {
+public:
+    static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+    /**
+    * @brief Builds the automaton for the delimiter unless it is already compiled, and resets the match state.
+    */
+    auto compile(const char* delimiter, std::size_t delimiterSize) -> void {
+        state = 0;
+
+        if (delimiterSize == pattern.size() && memcmp(delimiter, pattern.data(), delimiterSize) == 0) {
+            return;
+        }
+
+        pattern.assign(delimiter, delimiterSize);
+        failure.assign(delimiterSize, 0);
+
+        for (std::size_t i{1}, length{0}; i < delimiterSize; i++) {
+            while (length > 0 && pattern[i] != pattern[length]) {
+                length = failure[length - 1];
+            }
+
+            if (pattern[i] == pattern[length]) {
+                length++;
+            }
+
+            failure[i] = length;
+        }
+    }
+
+    /**
+    * @brief Forgets a partial match, the next byte fed starts a new search.
+    */
+    auto reset() -> void {
+        state = 0;
+    }
+
+    auto size() const -> std::size_t {
+        return pattern.size();
+    }
+
+    /**
+    * @brief Feeds the next chunk of received bytes.
+    * @return Returns the index right behind the end of the delimiter in this chunk or `npos` if it has not been completed yet
+    */
+    auto feed(const char* data, std::size_t size) -> std::size_t {
+        if (pattern.empty()) {
+            return npos;
+        }
+
+        for (std::size_t i{0}; i < size; i++) {
+            if (state == 0) {
+                i += findByte(data + i, size - i, pattern[0]);
+
+                if (i == size) {
+                    return npos;
+                }
+            }
+
+            while (state > 0 && data[i] != pattern[state]) {
+                state = failure[state - 1];
+            }
+
+            if (data[i] == pattern[state]) {
+                state++;
+            }
+
+            if (state == pattern.size()) {
+                state = 0;
+                return i + 1;
+            }
+        }
+
+        return npos;
+    }
+
+private:
+    std::string pattern;
+    std::vector<std::size_t> failure;
+    std::size_t state{0};
+};
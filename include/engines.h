@@ -0,0 +1,15 @@
+#pragma once
+
+/*
+* I/O engine a port is serviced by, selected when the port is opened.
+*/
+enum class Engines {
+    // Every call blocks in its own system call
+    BLOCKING = 0,
+    // One epoll thread drains every port into a receive buffer (Linux only)
+    REACTOR = 1,
+    // Reads and writes of every port are batched through one io_uring (Linux only)
+    IO_URING = 2,
+    // A reader thread per port drains the tty into a lock free ring (Linux only)
+    BUFFERED = 3
+};
@@ -0,0 +1,161 @@
+#pragma once
+#if defined(__linux__)
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <map>
+#include <utility>
+#include <vector>
+
+#include "coroutine_task.h"
+
+namespace serial {
+
+    /**
+    * @brief Runs coroutines on the calling thread and resumes them when their file descriptor is ready.
+    *
+    * Every port registers its file descriptor once with the epoll instance of the
+    * loop. A coroutine that has to wait parks itself on the channel of its port
+    * and the channel is armed for exactly the events that somebody waits for.
+    * Deadlines are kept in an ordered timer map, the earliest one bounds the
+    * `epoll_wait` timeout. Coroutines are never resumed while events are being
+    * dispatched, they are collected first and resumed afterwards, so a resumed
+    * coroutine may close its port or start new waits.
+    *
+    * Thousands of ports can share one loop without a thread each. The loop, its
+    * ports and their tasks belong to the thread that runs the loop, only `stop`
+    * may be called from other threads. Tasks that are still suspended when the
+    * loop is destroyed are not resumed anymore.
+    */
+    class EventLoop {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using TimerId = std::pair<Clock::time_point, std::uint64_t>;
+
+        struct Channel;
+
+        // A coroutine that waits for a channel
+        struct Waiter {
+            std::coroutine_handle<> coroutine;
+            Channel* channel{nullptr};
+            std::uint32_t events{0};
+            bool timed{false};
+            TimerId timer{};
+            int result{0};
+        };
+
+        // The registration of a file descriptor, at most one reader and one writer wait for it at a time
+        struct Channel {
+            int fd{-1};
+            bool attached{false};
+            Waiter* reader{nullptr};
+            Waiter* writer{nullptr};
+        };
+
+        /**
+        * @brief Suspends the coroutine until the channel is ready, the timeout has passed or the wait gets cancelled.
+        * Resumes with the epoll events, `0` on timeout or a negative status code.
+        */
+        class Wait {
+        public:
+            Wait(EventLoop &loop, Channel &channel, std::uint32_t events, int timeout);
+            ~Wait();
+
+            Wait(const Wait&) = delete;
+            auto operator=(const Wait&) -> Wait& = delete;
+
+            auto await_ready() const noexcept -> bool {
+                return false;
+            }
+
+            auto await_suspend(std::coroutine_handle<> coroutine) -> bool;
+
+            auto await_resume() const noexcept -> int {
+                return waiter.result;
+            }
+
+        private:
+            EventLoop &loop;
+            int timeout;
+            Waiter waiter;
+        };
+
+        EventLoop();
+        ~EventLoop();
+
+        EventLoop(const EventLoop&) = delete;
+        auto operator=(const EventLoop&) -> EventLoop& = delete;
+
+        /**
+        * @brief Starts the task on the next turn of the loop, it is destroyed once it has finished.
+        * A spawned task that throws terminates the program, like a thread would.
+        */
+        auto spawn(Task<void> task) -> void;
+
+        /**
+        * @brief Runs the loop until the task has finished and returns its result.
+        */
+        template <typename T>
+        auto run(Task<T> task) -> T {
+            if (!task.done()) {
+                ready.push_back(task.coroutine);
+            }
+
+            while (!task.done()) {
+                turn();
+            }
+
+            return task.promise->result();
+        }
+
+        /**
+        * @brief Runs the loop until `stop` is called.
+        */
+        auto run() -> void;
+
+        /**
+        * @brief Makes `run` return after the current turn, can be called from any thread.
+        */
+        auto stop() -> void;
+
+        /**
+        * @brief Registers the file descriptor of the channel, it is not armed until a coroutine waits for it.
+        */
+        auto attach(Channel &channel, int fd) -> bool;
+
+        /**
+        * @brief Removes the registration of the channel, its waiters resume with `CANCELLED_ERROR`.
+        */
+        auto detach(Channel &channel) -> void;
+
+        /**
+        * @brief Resumes the waiters of the channel with `CANCELLED_ERROR`, the registration stays.
+        */
+        auto cancel(Channel &channel) -> void;
+
+        /**
+        * @brief Waits for the epoll events of the channel for up to `timeout` ms, a negative timeout waits forever.
+        */
+        auto wait(Channel &channel, std::uint32_t events, int timeout) -> Wait;
+
+    private:
+        auto turn() -> void;
+        auto arm(Channel &channel) -> void;
+        auto complete(Waiter &waiter, int result) -> void;
+        auto resumeReady() -> void;
+        auto nextTimeout() const -> int;
+
+        int epollFd{-1};
+        int wakeFd{-1};
+        std::atomic<bool> stopping{false};
+
+        std::uint64_t nextTimer{1};
+        std::map<TimerId, Waiter*> timers;
+
+        // Coroutines to resume on this turn and the ones queued while they run
+        std::vector<std::coroutine_handle<>> ready;
+        std::vector<std::coroutine_handle<>> resuming;
+    };
+}
+#endif
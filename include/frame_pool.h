@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace serial {
+
+    /**
+    * @brief Recycles the coroutine frames of a port, so that reads and writes in the steady state do not allocate.
+    *
+    * Frames are rounded up to size classes of `granularity` bytes. A freed frame
+    * goes onto the free list of its class and is handed to the next coroutine of
+    * the same size, the memory only returns to the heap when the pool is deleted.
+    * Frames larger than `maxFrameSize` and frames without a pool come from the
+    * heap directly. Every frame starts with a header that names its pool, so a
+    * frame can be freed without knowing where it came from.
+    *
+    * The owner of a pool calls `release` instead of deleting it. Frames that are
+    * still in use at that point keep the pool alive, the last one deletes it.
+    * A pool belongs to the thread of its event loop and is not synchronized.
+    */
+    class FramePool {
+    public:
+        static constexpr std::size_t granularity = 64;
+        static constexpr std::size_t maxFrameSize = 4096;
+
+        FramePool() = default;
+
+        FramePool(const FramePool&) = delete;
+        auto operator=(const FramePool&) -> FramePool& = delete;
+
+        /**
+        * @brief Returns a frame of at least `size` bytes, from the free lists of the pool if it is not `nullptr`.
+        */
+        static auto allocate(FramePool* pool, std::size_t size) -> void*;
+
+        /**
+        * @brief Returns the frame to the pool it was allocated from or to the heap.
+        */
+        static auto deallocate(void* frame) -> void;
+
+        /**
+        * @brief Gives up the ownership of the pool, it is deleted once no frame is in use anymore.
+        */
+        auto release() -> void;
+
+        /**
+        * @brief Returns the number of frames that had to be taken from the heap.
+        */
+        auto allocations() const -> std::uint64_t;
+
+    private:
+        // Keeps the frame behind it aligned like memory from `operator new`
+        struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) Header {
+            FramePool* pool;
+            std::size_t sizeClass;
+        };
+
+        // A freed frame holds the link to the next free frame of its class
+        struct FreeFrame {
+            FreeFrame* next;
+        };
+
+        static constexpr std::size_t classCount = maxFrameSize / granularity;
+
+        ~FramePool();
+
+        std::array<FreeFrame*, classCount + 1> freeFrames{};
+        std::size_t inUse{0};
+        std::uint64_t heapAllocations{0};
+        bool released{false};
+    };
+}
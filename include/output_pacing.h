@@ -0,0 +1,121 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+
+#include "deadline.h"
+
+// Bits a byte takes on the line, one start bit, eight data bits and one stop bit
+constexpr long long bitsPerByte = 10;
+
+/**
+* @brief Returns the number of bytes the line sends within `budget` milliseconds, at least one.
+*/
+inline auto pacingLimit(const int baudrate, const int budget) -> std::size_t {
+    return static_cast<std::size_t>(std::max(1LL, static_cast<long long>(baudrate) * budget / (bitsPerByte * 1000)));
+}
+
+/**
+* @brief Returns the time the line takes to send the bytes, at least a millisecond.
+*/
+inline auto transmitTime(const std::size_t bytes, const int baudrate) -> std::chrono::milliseconds {
+    const long long rate = std::max(baudrate, 1);
+    return std::chrono::milliseconds(std::max(1LL, (static_cast<long long>(bytes) * bitsPerByte * 1000 + rate - 1) / rate));
+}
+
+/**
+* @brief Sleeps until the output queue of the system holds at most `limit` bytes or the deadline has passed.
+*
+* Instead of polling, every sleep lasts as long as the line needs to send the
+* bytes above the limit, so a long backlog costs a handful of wakeups.
+*
+* @param backlog Returns the number of bytes in the output queue or `-1` if that is unknown
+* @return Returns the last backlog, above `limit` if the deadline passed first or `-1` if it is unknown
+*/
+template <typename Backlog>
+auto waitForBacklog(
+    Backlog backlog,
+    const std::size_t limit,
+    const int baudrate,
+    const Deadline &deadline
+) -> int {
+    while (true) {
+        const int bytes = backlog();
+
+        if (bytes < 0 || static_cast<std::size_t>(bytes) <= limit) {
+            return bytes;
+        }
+
+        const int remaining = deadline.remaining();
+
+        if (remaining == 0) {
+            return bytes;
+        }
+
+        auto wait = transmitTime(static_cast<std::size_t>(bytes) - limit, baudrate);
+
+        if (remaining > 0) {
+            wait = std::min(wait, std::chrono::milliseconds(remaining));
+        }
+
+        std::this_thread::sleep_for(wait);
+    }
+}
+
+/**
+* @brief Writes the bytes in pieces that keep the output queue of the system at most `limit` bytes deep.
+*
+* The rest of the bytes stays with the caller until the line has sent enough,
+* so a command written afterwards waits behind at most `limit` bytes. The queue
+* is topped up to `limit` once it has run down to half of it, which keeps the
+* line busy with few wakeups. If the depth of the output queue is unknown the
+* bytes are written unpaced.
+*
+* @param backlog Returns the number of bytes in the output queue or `-1` if that is unknown
+* @param writeSome Writes at most `size` bytes of `data` and returns the number of bytes written,
+* `0` on timeout or a negative status code
+* @return Returns the status code of the failed write (negative) or the number of bytes written
+*/
+template <typename Backlog, typename WriteSome>
+auto pacedWrite(
+    const char* data,
+    const std::size_t size,
+    const std::size_t limit,
+    const int baudrate,
+    Backlog backlog,
+    WriteSome writeSome,
+    const Deadline &deadline
+) -> int {
+    std::size_t written = 0;
+
+    while (written < size) {
+        const int bytes = waitForBacklog(backlog, limit / 2, baudrate, deadline);
+
+        std::size_t room = size - written;
+
+        if (bytes >= 0) {
+            if (static_cast<std::size_t>(bytes) > limit / 2) {
+                break;
+            }
+
+            room = std::min(room, limit - static_cast<std::size_t>(bytes));
+        }
+
+        const int result = writeSome(data + written, room);
+
+        // Error if write fails, the bytes written so far are reported instead
+        if (result < 0) {
+            return written > 0 ? static_cast<int>(written) : result;
+        }
+
+        written += static_cast<std::size_t>(result);
+
+        if (result == 0 && deadline.expired()) {
+            break;
+        }
+    }
+
+    return static_cast<int>(written);
+}
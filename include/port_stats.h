@@ -0,0 +1,185 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "serial.h"
+
+/**
+* @brief Histogram with logarithmic buckets, like an HDR histogram with three significant bits.
+*
+* Values below 16 get a bucket of their own, above that every power of two is
+* split into 8 buckets, so a bucket is at most 12.5% wide over the whole 64 bit
+* range. The lower bound of bucket `i` is `i` for `i < 16`, otherwise
+* `(8 + i % 8) << (i / 8 - 1)`.
+*
+* Recording is a single relaxed increment, the counts are only read when
+* the statistics get scraped.
+*/
+class LogHistogram {
+public:
+    static constexpr std::size_t subBucketBits = 3;
+    static constexpr std::size_t subBucketCount = 1 << subBucketBits;
+    static constexpr std::size_t bucketCount = (64 - subBucketBits + 1) * subBucketCount;
+
+    static constexpr auto bucketOf(const std::uint64_t value) -> std::size_t {
+        if (value < 2 * subBucketCount) {
+            return static_cast<std::size_t>(value);
+        }
+
+        const std::size_t shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - subBucketBits;
+
+        return (shift + 1) * subBucketCount + static_cast<std::size_t>((value >> shift) & (subBucketCount - 1));
+    }
+
+    auto record(const std::uint64_t value) -> void {
+        counts[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    auto copyTo(std::uint64_t* destination) const -> void {
+        for (std::size_t i{0}; i < bucketCount; i++) {
+            destination[i] = counts[i].load(std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::array<std::atomic<std::uint64_t>, bucketCount> counts{};
+};
+
+/**
+* @brief Always on instrumentation of the calls on a port.
+*
+* Every read and write records its latency and transferred bytes into the
+* histograms and bumps the counters, all with relaxed atomics. Calls never
+* wait for each other or for a scrape, `snapshot` may run concurrently and
+* sees every counter at some recent value.
+*/
+class PortStats {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Histograms that follow the `PortStatistics` header of a snapshot, in this order
+    static constexpr std::size_t histogramCount = 4;
+    static constexpr std::size_t snapshotSize = sizeof(PortStatistics) + histogramCount * LogHistogram::bucketCount * sizeof(std::uint64_t);
+
+    /**
+    * @brief Runs the read and records its outcome.
+    * @param requested The number of bytes the caller asked for
+    * @param call Performs the read and returns the number of bytes read or a status code
+    */
+    template <typename Call>
+    auto read(const int requested, Call call) -> int {
+        const auto start = Clock::now();
+        const int result = call();
+        recordRead(start, requested, result);
+        return result;
+    }
+
+    /**
+    * @brief Runs the write and records its outcome.
+    * @param requested The number of bytes the caller wanted to write
+    * @param call Performs the write and returns the number of bytes written or a status code
+    */
+    template <typename Call>
+    auto write(const int requested, Call call) -> int {
+        const auto start = Clock::now();
+        const int result = call();
+        recordWrite(start, requested, result);
+        return result;
+    }
+
+    auto recordRead(const Clock::time_point start, const int requested, const int result) -> void {
+        readLatency.record(elapsed(start));
+        reads.fetch_add(1, std::memory_order_relaxed);
+
+        if (result < 0) {
+            readErrors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        readBytes.record(static_cast<std::uint64_t>(result));
+        bytesRead.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+
+        if (result == 0 && requested > 0) {
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+        } else if (result < requested) {
+            shortReads.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    auto recordWrite(const Clock::time_point start, const int requested, const int result) -> void {
+        writeLatency.record(elapsed(start));
+        writes.fetch_add(1, std::memory_order_relaxed);
+
+        if (result < 0) {
+            writeErrors.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        writeBytes.record(static_cast<std::uint64_t>(result));
+        bytesWritten.fetch_add(static_cast<std::uint64_t>(result), std::memory_order_relaxed);
+
+        if (result == 0 && requested > 0) {
+            timeouts.fetch_add(1, std::memory_order_relaxed);
+        } else if (result < requested) {
+            shortWrites.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+    * @brief Writes the `PortStatistics` header followed by the read latency, write latency,
+    * read bytes and write bytes histograms. The destination must hold `snapshotSize` bytes.
+    */
+    auto snapshot(char* destination) const -> void {
+        const PortStatistics header{
+            static_cast<std::uint32_t>(LogHistogram::bucketCount),
+            static_cast<std::uint32_t>(histogramCount),
+            reads.load(std::memory_order_relaxed),
+            writes.load(std::memory_order_relaxed),
+            bytesRead.load(std::memory_order_relaxed),
+            bytesWritten.load(std::memory_order_relaxed),
+            timeouts.load(std::memory_order_relaxed),
+            shortReads.load(std::memory_order_relaxed),
+            shortWrites.load(std::memory_order_relaxed),
+            readErrors.load(std::memory_order_relaxed),
+            writeErrors.load(std::memory_order_relaxed)
+        };
+
+        memcpy(destination, &header, sizeof(header));
+
+        std::uint64_t histogram[LogHistogram::bucketCount];
+        char *position = destination + sizeof(header);
+
+        for (const LogHistogram *source : {&readLatency, &writeLatency, &readBytes, &writeBytes}) {
+            source->copyTo(histogram);
+            memcpy(position, histogram, sizeof(histogram));
+            position += sizeof(histogram);
+        }
+    }
+
+private:
+    static auto elapsed(const Clock::time_point start) -> std::uint64_t {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+    }
+
+    // Latencies in nanoseconds, sizes in bytes per call
+    LogHistogram readLatency;
+    LogHistogram writeLatency;
+    LogHistogram readBytes;
+    LogHistogram writeBytes;
+
+    std::atomic<std::uint64_t> reads{0};
+    std::atomic<std::uint64_t> writes{0};
+    std::atomic<std::uint64_t> bytesRead{0};
+    std::atomic<std::uint64_t> bytesWritten{0};
+    std::atomic<std::uint64_t> timeouts{0};
+    std::atomic<std::uint64_t> shortReads{0};
+    std::atomic<std::uint64_t> shortWrites{0};
+    std::atomic<std::uint64_t> readErrors{0};
+    std::atomic<std::uint64_t> writeErrors{0};
+};
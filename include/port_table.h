@@ -0,0 +1,115 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+/**
+* @brief Fixed size table that maps opaque integer handles to open ports.
+*
+* A handle packs the slot index into the low bits and a per slot generation
+* counter into the high bits, so a handle of a closed port is never mistaken
+* for a port that later reuses the same slot. Handles are always positive,
+* which keeps them apart from the (negative) status codes.
+*
+* Lookups only take a shared lock and hand out a `std::shared_ptr`, so calls on
+* different ports never serialize on each other and a port stays alive until
+* the last in-flight call on it has returned, even if it was closed meanwhile.
+*/
+template <typename Port, std::size_t Capacity = 4096>
+class PortTable {
+    static constexpr int slotBits = 12;
+    static constexpr int slotMask = (1 << slotBits) - 1;
+    static constexpr unsigned generationMask = 0x7FFFF;
+
+    static_assert(Capacity <= (1 << slotBits), "Capacity does not fit into the slot bits of a handle");
+
+public:
+    /**
+    * @brief Stores the port in a free slot.
+    * @return Returns the handle of the port or `-1` if the table is full
+    */
+    auto insert(std::shared_ptr<Port> port) -> int {
+        std::unique_lock lock(mutex);
+
+        for (std::size_t i{0}; i < Capacity; i++) {
+            Slot &slot = slots[i];
+
+            if (slot.port) {
+                continue;
+            }
+
+            slot.generation = (slot.generation + 1) & generationMask;
+            if (slot.generation == 0) {
+                slot.generation = 1;
+            }
+            slot.port = std::move(port);
+
+            return static_cast<int>(slot.generation << slotBits) | static_cast<int>(i);
+        }
+
+        return -1;
+    }
+
+    /**
+    * @brief Looks up the port behind the handle.
+    * @return Returns the port or `nullptr` if the handle is unknown or already closed
+    */
+    auto find(const int handle) -> std::shared_ptr<Port> {
+        std::shared_lock lock(mutex);
+
+        Slot *slot = resolve(handle);
+        return slot ? slot->port : nullptr;
+    }
+
+    /**
+    * @brief Removes the port behind the handle from the table.
+    * @return Returns the removed port or `nullptr` if the handle is unknown or already closed
+    */
+    auto remove(const int handle) -> std::shared_ptr<Port> {
+        std::unique_lock lock(mutex);
+
+        Slot *slot = resolve(handle);
+        return slot ? std::move(slot->port) : nullptr;
+    }
+
+    /**
+    * @brief Calls the function for every open port.
+    */
+    template <typename Function>
+    auto forEach(Function function) -> void {
+        std::shared_lock lock(mutex);
+
+        for (Slot &slot : slots) {
+            if (slot.port) {
+                function(*slot.port);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        std::shared_ptr<Port> port;
+        unsigned generation{0};
+    };
+
+    auto resolve(const int handle) -> Slot* {
+        if (handle <= 0) {
+            return nullptr;
+        }
+
+        const std::size_t index = static_cast<std::size_t>(handle & slotMask);
+        const unsigned generation = static_cast<unsigned>(handle) >> slotBits;
+
+        if (index >= Capacity || !slots[index].port || slots[index].generation != generation) {
+            return nullptr;
+        }
+
+        return &slots[index];
+    }
+
+    std::array<Slot, Capacity> slots;
+    std::shared_mutex mutex;
+};
@@ -0,0 +1,11 @@
+#pragma once
+
+/*
+* Class of the bytes that are put into the write queue of a port.
+*/
+enum class Priorities {
+    // Goes out in slices and only while the kernel holds at most one slice of it
+    BULK = 0,
+    // Goes out at the next slice boundary of the bulk bytes, without waiting to coalesce
+    URGENT = 1
+};
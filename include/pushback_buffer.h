@@ -0,0 +1,63 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+/**
+* @brief Bytes that were already received from a port but not handed out yet.
+* Every read of the port is served from here first, so nothing read ahead gets lost.
+*/
+class PushbackBuffer {
+public:
+    auto empty() const -> bool {
+        return head == data.size();
+    }
+
+    auto size() const -> std::size_t {
+        return data.size() - head;
+    }
+
+    /**
+    * @brief Moves up to `size` bytes from the front into `destination`.
+    * @return Returns the number of bytes moved
+    */
+    auto take(char* destination, std::size_t size) -> std::size_t {
+        const std::size_t count = std::min(size, this->size());
+
+        memcpy(destination, data.data() + head, count);
+        head += count;
+
+        if (head == data.size()) {
+            data.clear();
+            head = 0;
+        }
+
+        return count;
+    }
+
+    /**
+    * @brief Puts the bytes back in front of everything that is still buffered.
+    */
+    auto pushFront(const char* bytes, std::size_t size) -> void {
+        if (size == 0) {
+            return;
+        }
+
+        // Bytes that were just taken are usually still in place in front of the head
+        if (head >= size) {
+            head -= size;
+            memmove(data.data() + head, bytes, size);
+            return;
+        }
+
+        data.erase(data.begin(), data.begin() + head);
+        data.insert(data.begin(), bytes, bytes + size);
+        head = 0;
+    }
+
+private:
+    std::vector<char> data;
+    std::size_t head{0};
+};
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "delimiter_matcher.h"
+#include "pushback_buffer.h"
+
+/**
+* @brief Reads as many complete lines into the buffer as have been received, so a consumer crosses into the library once per batch instead of once per line.
+*
+* Bytes are only waited for until the first line is complete, after that the
+* batch takes what has already been received and stops. The start and end
+* offset of every line go into `offsets`, the end excludes the delimiter.
+* Everything behind the last complete line, like an unfinished trailing line,
+* goes into the pushback buffer of the port for the next call. A buffer that
+* fills up without a single delimiter is handed out as one line, so an overlong
+* line can not stall the port.
+*
+* @param offsets Receives the start and end offset of every line, it must hold `2 * maxLines` entries
+* @param matcher The compiled matcher of the delimiter, its match state is reset first
+* @param readSome Reads at most `size` bytes into `destination`, only waiting for them if `wait` is set,
+* and returns the number of bytes read, `0` on timeout or a negative status code
+* @param consumed Receives the number of bytes handed out, including the delimiters
+* @return Returns the status code of the failed read (negative) or the number of lines
+*/
+template <typename ReadSome>
+auto readLineBatch(
+    PushbackBuffer &pushback,
+    char* buffer,
+    const std::size_t bufferSize,
+    std::uint32_t* offsets,
+    const std::size_t maxLines,
+    DelimiterMatcher &matcher,
+    ReadSome readSome,
+    std::size_t &consumed
+) -> int {
+    matcher.reset();
+
+    std::size_t filled = pushback.take(buffer, bufferSize);
+    std::size_t scanned = 0;
+    std::size_t lineStart = 0;
+    std::size_t lines = 0;
+
+    while (true) {
+        while (lines < maxLines) {
+            const std::size_t matchEnd = matcher.feed(buffer + scanned, filled - scanned);
+
+            if (matchEnd == DelimiterMatcher::npos) {
+                scanned = filled;
+                break;
+            }
+
+            scanned += matchEnd;
+            offsets[2 * lines] = static_cast<std::uint32_t>(lineStart);
+            offsets[2 * lines + 1] = static_cast<std::uint32_t>(scanned - matcher.size());
+            lineStart = scanned;
+            lines++;
+        }
+
+        if (lines == maxLines || filled == bufferSize) {
+            break;
+        }
+
+        const int bytesRead = readSome(buffer + filled, bufferSize - filled, lines == 0);
+
+        // Error if read fails, the bytes received so far stay available for the next read
+        if (bytesRead < 0 && lines == 0) {
+            pushback.pushFront(buffer, filled);
+            return bytesRead;
+        }
+
+        if (bytesRead <= 0) {
+            break;
+        }
+
+        filled += static_cast<std::size_t>(bytesRead);
+    }
+
+    if (lines == 0 && filled == bufferSize && bufferSize > 0) {
+        offsets[0] = 0;
+        offsets[1] = static_cast<std::uint32_t>(bufferSize);
+        lineStart = bufferSize;
+        lines = 1;
+    }
+
+    pushback.pushFront(buffer + lineStart, filled - lineStart);
+    consumed = lineStart;
+
+    return static_cast<int>(lines);
+}
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstddef>
+
+#include "delimiter_matcher.h"
+#include "pushback_buffer.h"
+
+/**
+* @brief Reads into the buffer until the delimiter was received, the buffer is full or a read returns no bytes.
+*
+* Bytes are read in bulk straight into the buffer and every byte is fed to the
+* matcher of the port exactly once, a delimiter that straddles two reads is
+* still found. Everything that was received after the delimiter goes into the
+* pushback buffer of the port. The delimiter is part of the returned bytes, an
+* empty delimiter reads until the buffer is full.
+*
+* @param matcher The compiled matcher of the delimiter, its match state is reset first
+* @param readSome Reads at most `size` bytes into `destination` and returns
+* the number of bytes read, `0` on timeout or a negative status code
+* @return Returns the status code of the failed read (negative) or the number of bytes read
+*/
+template <typename ReadSome>
+auto readUntilDelimiter(
+    PushbackBuffer &pushback,
+    char* buffer,
+    const std::size_t bufferSize,
+    DelimiterMatcher &matcher,
+    ReadSome readSome
+) -> int {
+    matcher.reset();
+
+    std::size_t filled = pushback.take(buffer, bufferSize);
+    std::size_t scanned = 0;
+
+    while (true) {
+        const std::size_t matchEnd = matcher.feed(buffer + scanned, filled - scanned);
+
+        if (matchEnd != DelimiterMatcher::npos) {
+            const std::size_t end = scanned + matchEnd;
+            pushback.pushFront(buffer + end, filled - end);
+            filled = end;
+            break;
+        }
+
+        scanned = filled;
+
+        if (filled == bufferSize) {
+            break;
+        }
+
+        const int bytesRead = readSome(buffer + filled, bufferSize - filled);
+
+        // Error if read fails, the bytes received so far stay available for the next read
+        if (bytesRead < 0) {
+            pushback.pushFront(buffer, filled);
+            return bytesRead;
+        }
+
+        if (bytesRead == 0) {
+            break;
+        }
+
+        filled += static_cast<std::size_t>(bytesRead);
+    }
+
+    // Terminate the string if there is room left, like the byte wise implementation did
+    if (filled < bufferSize) {
+        buffer[filled] = '\0';
+    }
+
+    return static_cast<int>(filled);
+}
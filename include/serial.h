@@ -1,55 +1,165 @@
 #pragma once
 
-#ifdef SERIALPORT_EXPORTS
-/*Enabled as "export" while compiling the dll project*/
-#define DLL_IMPORT_EXPORT __declspec(dllexport)
-#else
-/*Enabled as "import" in the Client side for using already created dll file*/
-#define DLL_IMPORT_EXPORT __declspec(dllimport)
-#endif
+#include <cstdint>
 
-// Windows
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
-    #include "serial_windows.h"
-    #define _open(port, baudrate, dataBits, parity, stopBits) WindowsSystem::open(port, baudrate, dataBits, parity, stopBits)
-    #define _close() WindowsSystem::close()
-    #define _read(buffer, bufferSize, timeout, multiplier) WindowsSystem::read(buffer, bufferSize, timeout, multiplier)
-    #define _readUntil(buffer, bufferSize, timeout, multiplier, untilChar) WindowsSystem::readUntil(buffer, bufferSize, timeout, multiplier, untilChar)
-    #define _write(buffer, bufferSize, timeout, multiplier) WindowsSystem::write(buffer, bufferSize, timeout, multiplier)
-    #define _getAvailablePorts(buffer, bufferSize, separator) WindowsSystem::getAvailablePorts(buffer, bufferSize, separator)
+    #ifdef SERIALPORT_EXPORTS
+    /*Enabled as "export" while compiling the dll project*/
+    #define DLL_IMPORT_EXPORT __declspec(dllexport)
+    #else
+    /*Enabled as "import" in the Client side for using already created dll file*/
+    #define DLL_IMPORT_EXPORT __declspec(dllimport)
+    #endif
+#else
+    /*Shared objects export every symbol with default visibility*/
+    #define DLL_IMPORT_EXPORT __attribute__((visibility("default")))
 #endif
 
-// Linux, Apple
-#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
-    #include "serial_unix.h"
-    #define _open(port, baudrate, dataBits, parity, stopBits) UnixSystemOopen(port, baudrate, dataBits, parity, stopBits)
-    #define _close() UnixSystemClose()
-    #define _read(buffer, bufferSize, timeout, multiplier) UnixSystemRead(buffer, bufferSize, timeout, multiplier)
-    #define _readUntil(buffer, bufferSize, timeout, multiplier, untilChar) UnixSystemReadUntil(buffer, bufferSize, timeout, multiplier, untilChar)
-    #define _write(buffer, bufferSize, timeout, multiplier) UnixSystemWrite(buffer, bufferSize, timeout, multiplier)
-    // #define _getAvailablePorts() UnixSystemGetAvailablePorts()
-#endif
+/*
+* Layout of the receive ring of a port that `serialMapReceiveRing` hands out.
+* The consumer reads `capacity` (a power of two) bytes of data at `address + dataOffset`,
+* both indices are 32 bit, wrap around and are masked with `capacity - 1`.
+* The native reader thread advances the tail, the consumer advances the head.
+*/
+struct ReceiveRingDescriptor {
+    std::uint64_t address;
+    std::uint32_t capacity;
+    std::uint32_t headOffset;
+    std::uint32_t tailOffset;
+    std::uint32_t dataOffset;
+};
+
+/*
+* Record `serialWaitCompletions` writes for every finished request, `result`
+* is what the synchronous call would have returned.
+*/
+struct Completion {
+    std::uint32_t requestId;
+    std::int32_t result;
+};
+
+/*
+* One piece of the memory `serialReadv` scatters into and `serialWritev` gathers from.
+*/
+struct IoSegment {
+    std::uint64_t address;
+    std::uint64_t length;
+};
 
+/*
+* Counts `serialTransact` writes back, `bytesRead` is also its return value.
+*/
+struct TransactResult {
+    std::int32_t bytesWritten;
+    std::int32_t bytesRead;
+};
+
+/*
+* Header of the statistics `serialGetStats` copies. It is followed by `histogramCount`
+* histograms of `bucketCount` 64 bit counts each: read latency and write latency in
+* nanoseconds, bytes per read and bytes per write. The lower bound of bucket `i`
+* is `i` for `i < 16`, otherwise `(8 + i % 8) << (i / 8 - 1)`.
+* A call that transferred nothing counts as timeout, one that transferred less
+* than asked for as short read/write.
+*/
+struct PortStatistics {
+    std::uint32_t bucketCount;
+    std::uint32_t histogramCount;
+    std::uint64_t reads;
+    std::uint64_t writes;
+    std::uint64_t bytesRead;
+    std::uint64_t bytesWritten;
+    std::uint64_t timeouts;
+    std::uint64_t shortReads;
+    std::uint64_t shortWrites;
+    std::uint64_t readErrors;
+    std::uint64_t writeErrors;
+};
+
+/*
+* What `serialTuneLatency` found and applied. The latency timers are in
+* milliseconds, `-1` marks a setting the device does not have.
+*/
+struct LatencyTuning {
+    std::int32_t previousLatencyTimer;
+    std::int32_t latencyTimer;
+    std::int32_t lowLatency;
+};
+
+/*
+* One port as `serialEnumeratePorts` describes it. Strings are NUL terminated
+* and cut off if they do not fit. Ports that are no USB device have a
+* `vendorId`/`productId` of `0`, an empty serial number and an
+* `interfaceNumber` of `-1`.
+*/
+struct PortInfo {
+    char path[128];
+    char serialNumber[64];
+    char driver[32];
+    std::uint16_t vendorId;
+    std::uint16_t productId;
+    std::int32_t interfaceNumber;
+};
+
+/*
+* State of the write queue of a port as `serialGetWriteQueueStatus` copies it.
+* `depth` counts the bytes that are queued or being written, `highWater` the
+* largest depth so far. `rejected` counts the writes that found no room within
+* their timeout, `errors` the chunks the device refused. `urgentBytes` counts
+* the bytes queued as `Priorities::URGENT`, `maxUrgentLatency` the longest time
+* in nanoseconds from queueing an urgent byte until it was handed to the system.
+*/
+struct WriteQueueStatus {
+    std::uint64_t capacity;
+    std::uint64_t depth;
+    std::uint64_t highWater;
+    std::uint64_t bytesQueued;
+    std::uint64_t bytesWritten;
+    std::uint64_t writes;
+    std::uint64_t rejected;
+    std::uint64_t errors;
+    std::uint64_t urgentBytes;
+    std::uint64_t maxUrgentLatency;
+};
+
+/*
+* Every port is addressed by the handle returned from `serialOpen`. Handles are
+* always positive, every negative return value is one of the `StatusCodes`.
+*
+* The exported names carry a `serial` prefix, so they do not clash with
+* `open`, `close`, `read` and `write` of the C library when the shared object
+* is linked into a native process.
+*/
 extern "C" {
 
-    DLL_IMPORT_EXPORT auto open(
+    DLL_IMPORT_EXPORT auto serialOpen(
         void* port,
         const int baudrate,
         const int dataBits,
         const int parity = 0,
-        const int stopBits = 0
+        const int stopBits = 0,
+        const int engine = 0,
+        const int receiveBufferSize = 0
     ) -> int;
 
-    DLL_IMPORT_EXPORT auto close() -> int;
+    DLL_IMPORT_EXPORT auto serialClose(
+        const int handle
+    ) -> int;
 
-    DLL_IMPORT_EXPORT auto read(
+    DLL_IMPORT_EXPORT auto serialCancel(
+        const int handle
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialRead(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier
     ) -> int;
 
-    DLL_IMPORT_EXPORT auto readUntil(
+    DLL_IMPORT_EXPORT auto serialReadUntil(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
@@ -57,17 +167,176 @@ extern "C" {
         void* untilChar
     ) -> int;
 
-    DLL_IMPORT_EXPORT auto write(
+    DLL_IMPORT_EXPORT auto serialReadLines(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        void* offsets,
+        const int maxLines,
+        const int timeout,
+        const int multiplier,
+        void* untilChar
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialWrite(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier
     ) -> int;
 
-    DLL_IMPORT_EXPORT auto getAvailablePorts(
+    DLL_IMPORT_EXPORT auto serialReadv(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialWritev(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialTransact(
+        const int handle,
+        void* request,
+        const int requestSize,
+        void* response,
+        const int responseSize,
+        const int timeout,
+        const int multiplier,
+        void* untilChar,
+        void* result,
+        const int resultSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialConfigureWriteQueue(
+        const int handle,
+        const int capacity,
+        const int coalesceBytes,
+        const int coalesceDelay,
+        const int sliceSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialEnqueueWrite(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int priority,
+        const int timeout
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialFlushWriteQueue(
+        const int handle,
+        const int timeout
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialGetWriteQueueStatus(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialSetPacing(
+        const int handle,
+        const int budget
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialSetCanonicalLines(
+        const int handle,
+        const int enabled
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialGetOutputBacklog(
+        const int handle
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialDrain(
+        const int handle,
+        const int timeout
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialSubmitRead(
+        const int handle,
+        const unsigned int requestId,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialSubmitReadUntil(
+        const int handle,
+        const unsigned int requestId,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier,
+        void* untilChar
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialSubmitWrite(
+        const int handle,
+        const unsigned int requestId,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialWaitCompletions(
+        void* completions,
+        const int maxCompletions,
+        const int timeout
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialTuneLatency(
+        const int handle,
+        const int latencyTimer,
+        const int lowLatency,
+        void* sysfsRoot,
+        void* result,
+        const int resultSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialGetBaudrate(
+        const int handle
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialGetStats(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialMapReceiveRing(
+        const int handle,
+        void* descriptor,
+        const int descriptorSize
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialGetAvailablePorts(
         void* buffer,
         const int bufferSize,
         void* separator
     ) -> int;
 
+    DLL_IMPORT_EXPORT auto serialEnumeratePorts(
+        void* buffer,
+        const int bufferSize,
+        void* sysfsRoot
+    ) -> int;
+
+    DLL_IMPORT_EXPORT auto serialPortsGeneration() -> int;
+
+    DLL_IMPORT_EXPORT auto serialWaitPortsChanged(
+        const int generation,
+        const int timeout
+    ) -> int;
+
 }
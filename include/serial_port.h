@@ -0,0 +1,140 @@
+#pragma once
+#if defined(__linux__)
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <string_view>
+
+#include "coroutine_task.h"
+#include "event_loop.h"
+#include "frame_pool.h"
+#include "serial_result.h"
+
+namespace serial {
+
+    /**
+    * @brief Open serial device whose reads and writes are coroutines on an `EventLoop`.
+    *
+    * A port owns its file descriptor, it is move-only and closes the device when
+    * it is destroyed. Buffers are spans of bytes and every call reports either its
+    * value or the status code it failed with, so there are no `void*` casts and no
+    * negative counts to check. Nothing is copied on the way, the bytes go straight
+    * between the spans and the tty.
+    *
+    * The operations follow the timeouts of the C API, but instead of blocking a
+    * thread they suspend until the tty is ready or their deadline has passed.
+    * Thousands of ports can be served by one loop this way, and a caller that
+    * wants to block hands the task to `EventLoop::run`. The coroutine frames come
+    * from the frame pool of the port, after the first few calls reading and
+    * writing does not allocate anymore.
+    *
+    * A port runs one read and one write at a time. A read that starts while
+    * another one is running fails with `BUSY_ERROR`, and so does a write that has
+    * to wait while another one waits. Buffers, delimiters and the port itself have
+    * to stay valid until the task of an operation has finished. Closing the port
+    * or destroying it resumes the waiting operations with `CANCELLED_ERROR`.
+    */
+    class Port {
+    public:
+        // A port that is not open, every operation fails with `INVALID_HANDLE_ERROR`
+        Port() = default;
+        ~Port();
+
+        Port(Port &&other) noexcept;
+        auto operator=(Port &&other) noexcept -> Port&;
+
+        Port(const Port&) = delete;
+        auto operator=(const Port&) -> Port& = delete;
+
+        /**
+        * @brief Opens the serial device and registers it with the event loop.
+        * @param loop The loop that runs the operations of the port, it has to outlive the port
+        * @param path The path of the serial device
+        * @param baudrate The baudrate
+        * @param dataBits The data bits
+        * @param parity The parity bits
+        * @param stopBits The stop bits
+        * @return Returns the open port or the status code
+        */
+        static auto open(
+            EventLoop &loop,
+            const char* path,
+            int baudrate,
+            int dataBits = 8,
+            int parity = 0,
+            int stopBits = 0
+        ) -> Result<Port>;
+
+        /**
+        * @brief Closes the port ahead of its destruction, waiting operations resume with `CANCELLED_ERROR`.
+        */
+        auto close() -> Result<void>;
+
+        /**
+        * @brief Resumes the waiting operations with `CANCELLED_ERROR` or the bytes they transferred so far.
+        */
+        auto cancel() -> void;
+
+        auto isOpen() const -> bool;
+
+        /**
+        * @brief Returns the handle of the port for the functions of the C API or `-1` if it is not open.
+        * The descriptor is non-blocking, reads and writes through the handle do not wait for the tty.
+        * Reads through the handle and reads of the port exclude each other. A read of the port fails with
+        * `BUSY_ERROR` while one through the handle runs, and one through the handle blocks until the read
+        * of the port has finished, so it must not be started on the thread of the loop.
+        */
+        auto handle() const -> int;
+
+        /**
+        * @brief Returns the pool the coroutine frames of the port come from, `nullptr` if it is not open.
+        */
+        auto framePool() const -> FramePool*;
+
+        /**
+        * @brief Reads until the buffer is full, like `serialRead`.
+        * @param timeout Timeout to cancel the read, also the longest gap between two received chunks
+        * @param multiplier Milliseconds per requested byte that are added to the timeout
+        * @return Returns the number of bytes read, `0` if none arrived in time, or the status code
+        */
+        auto read(std::span<std::byte> buffer, int timeout, int multiplier = 0) -> Task<Result<std::size_t>>;
+
+        /**
+        * @brief Reads until the delimiter was received or the buffer is full, like `serialReadUntil`.
+        * Bytes received after the delimiter are kept for the next read.
+        * @return Returns the number of bytes read including the delimiter or the status code
+        */
+        auto readUntil(
+            std::span<std::byte> buffer,
+            std::string_view delimiter,
+            int timeout,
+            int multiplier = 0
+        ) -> Task<Result<std::size_t>>;
+
+        /**
+        * @brief Writes the buffer, like `serialWrite`. Without any timeout it waits until everything is written.
+        * @return Returns the number of bytes written or the status code
+        */
+        auto write(std::span<const std::byte> buffer, int timeout, int multiplier = 0) -> Task<Result<std::size_t>>;
+
+        /**
+        * @brief Writes the request and reads the response until the delimiter, like `serialTransact`.
+        * @return Returns the number of bytes of the response or the status code
+        */
+        auto transact(
+            std::span<const std::byte> request,
+            std::span<std::byte> response,
+            std::string_view delimiter,
+            int timeout,
+            int multiplier = 0
+        ) -> Task<Result<std::size_t>>;
+
+    private:
+        struct State;
+
+        explicit Port(std::shared_ptr<State> state);
+
+        std::shared_ptr<State> state;
+    };
+}
+#endif
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <utility>
+
+#include "status_code_enum.h"
+
+namespace serial {
+
+    /**
+    * @brief Thrown by `Result::value` if the result holds a status code instead of a value.
+    */
+    class BadResultAccess : public std::exception {
+    public:
+        explicit BadResultAccess(const StatusCodes code) : code(code) {}
+
+        auto what() const noexcept -> const char* override {
+            return "serial::Result holds a status code";
+        }
+
+        auto error() const noexcept -> StatusCodes {
+            return code;
+        }
+
+    private:
+        StatusCodes code;
+    };
+
+    /**
+    * @brief Holds the error of a failed `Result`, like `std::unexpected`.
+    */
+    struct Failure {
+        StatusCodes code;
+    };
+
+    /**
+    * @brief Either the value of a call or the status code it failed with, shaped like `std::expected<T, StatusCodes>`.
+    * The C API reports both in one negative or positive `int`, a result keeps them apart.
+    */
+    template <typename T>
+    class [[nodiscard]] Result {
+    public:
+        Result(T result) : result(std::move(result)) {}
+        Result(const Failure failure) : code(failure.code) {}
+
+        auto has_value() const noexcept -> bool {
+            return result.has_value();
+        }
+
+        explicit operator bool() const noexcept {
+            return has_value();
+        }
+
+        auto value() & -> T& {
+            check();
+            return *result;
+        }
+
+        auto value() const & -> const T& {
+            check();
+            return *result;
+        }
+
+        auto value() && -> T&& {
+            check();
+            return std::move(*result);
+        }
+
+        template <typename Fallback>
+        auto value_or(Fallback &&fallback) const & -> T {
+            return result ? *result : static_cast<T>(std::forward<Fallback>(fallback));
+        }
+
+        auto operator*() & noexcept -> T& {
+            return *result;
+        }
+
+        auto operator*() const & noexcept -> const T& {
+            return *result;
+        }
+
+        auto operator*() && noexcept -> T&& {
+            return std::move(*result);
+        }
+
+        auto operator->() noexcept -> T* {
+            return &*result;
+        }
+
+        auto operator->() const noexcept -> const T* {
+            return &*result;
+        }
+
+        /**
+        * @brief Returns the status code, `SUCCESS` if the result holds a value.
+        */
+        auto error() const noexcept -> StatusCodes {
+            return code;
+        }
+
+    private:
+        auto check() const -> void {
+            if (!result) {
+                throw BadResultAccess(code);
+            }
+        }
+
+        std::optional<T> result;
+        StatusCodes code{StatusCodes::SUCCESS};
+    };
+
+    template <>
+    class [[nodiscard]] Result<void> {
+    public:
+        Result() = default;
+        Result(const Failure failure) : code(failure.code) {}
+
+        auto has_value() const noexcept -> bool {
+            return code == StatusCodes::SUCCESS;
+        }
+
+        explicit operator bool() const noexcept {
+            return has_value();
+        }
+
+        auto value() const -> void {
+            if (!has_value()) {
+                throw BadResultAccess(code);
+            }
+        }
+
+        auto error() const noexcept -> StatusCodes {
+            return code;
+        }
+
+    private:
+        StatusCodes code{StatusCodes::SUCCESS};
+    };
+
+    /**
+    * @brief Turns the return value of a C API call, a byte count or a negative status code, into a result.
+    */
+    inline auto resultOf(const int result) -> Result<std::size_t> {
+        if (result < 0) {
+            return Failure{static_cast<StatusCodes>(result)};
+        }
+
+        return static_cast<std::size_t>(result);
+    }
+
+    /**
+    * @brief Turns a status code into a result without a value.
+    */
+    inline auto resultOfStatus(const int result) -> Result<void> {
+        if (result < 0) {
+            return Failure{static_cast<StatusCodes>(result)};
+        }
+
+        return {};
+    }
+}
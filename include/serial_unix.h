@@ -8,6 +8,8 @@
 #include <fcntl.h>      // File control definitions
 #include <errno.h>      // Error number definitions
 #include <system_error>	// For throwing std::system_error
+#include <sys/uio.h>    // Used for readv/writev
+#include <climits>
 #include <sys/ioctl.h> // Used for TCGETS2, which is required for custom baud rates
 #include <cassert>
 #include <asm/ioctls.h>
@@ -15,25 +17,124 @@
 #include <algorithm>
 #include <iterator>
 #include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <condition_variable>
+#include <atomic>
+#include <thread>
+#include <string>
+#include <vector>
 
+#include "serial.h"
 #include "status_codes.h"
+#include "engines.h"
+#include "port_table.h"
+#include "port_stats.h"
+#include "transmit_queue.h"
+#include "output_pacing.h"
+#include "deadline.h"
+#include "pushback_buffer.h"
+#include "delimiter_matcher.h"
+#include "read_until.h"
+#include "read_lines.h"
+#include "spsc_ring.h"
+#if defined(__linux__)
+#include "unix_reactor.h"
+#include "unix_uring.h"
+#include "unix_latency.h"
+#include "unix_ports.h"
+#include "unix_port_registry.h"
+#include "unix_cancellation.h"
+#endif
 
 namespace UnixSystem {
 
-    extern int hSerialPort;
-    extern termios2 tty;
+    struct Port {
+        std::string path;
+        int hSerialPort{-1};
+        termios2 tty{};
+        Engines engine{Engines::BLOCKING};
+
+        // Serializes the reads of the port, bytes read ahead by readUntil wait in the pushback buffer,
+        // the matcher of the last readUntil delimiter is kept for the next call
+        std::mutex readMutex;
+        PushbackBuffer pushback;
+        DelimiterMatcher delimiterMatcher;
+
+        // Line mode of the tty, guarded by the read mutex. Once `canonicalLines` is set and readUntil repeats the
+        // same single byte delimiter, the line discipline splits the lines itself and `tty` keeps the raw configuration.
+        bool canonicalLines{false};
+        bool canonical{false};
+        char lineDelimiter{0};
+        int lineDelimiterRepeats{0};
+
+        // Receive state of the reactor engine, filled by the reactor thread
+        std::uint64_t reactorId{0};
+        std::mutex receiveMutex;
+        std::condition_variable receiveReady;
+        std::vector<char> receiveBuffer;
+        std::size_t receiveHead{0};
+        bool receivePaused{false};
+        std::atomic<bool> hungUp{false};
+
+        // Receive state of the buffered engine, the reader thread is the only producer of the ring.
+        // The mutex and condition variables above are only used when one side has to sleep.
+        std::unique_ptr<SpscRing> receiveRing;
+        std::thread readerThread;
+        int readerStopFd{-1};
+        std::atomic<bool> readerStopping{false};
+        std::atomic<bool> consumerWaiting{false};
+        std::atomic<bool> producerWaiting{false};
+        std::atomic<bool> receiveRingMapped{false};
+        std::condition_variable receiveSpace;
+
+        // Registered buffer slots of the io_uring engine, guarded by the receive and transmit mutex
+        std::mutex transmitMutex;
+        int uringReceiveBuffer{-1};
+        int uringTransmitBuffer{-1};
+
+        // Latency and throughput of the calls on the port
+        PortStats stats;
+
+        // Write queue that a writer thread drains, created on first use
+        std::mutex transmitQueueMutex;
+        std::shared_ptr<TransmitQueue> transmitQueue;
+
+        // Milliseconds of output the tty may hold before writes wait, `0` if the port is not paced
+        std::atomic<int> pacingBudget{0};
+
+#if defined(__linux__)
+        // Wakes the waits of the port on cancel, io_uring operations in flight are aborted inside the kernel
+        Cancellation cancellation;
+        Uring::Operations uringOperations;
+#endif
+
+        ~Port();
+    };
+
+    extern PortTable<Port> ports;
 
     auto open(
         void* port,
         const int baudrate,
         const int dataBits,
         const int parity = 0,
-        const int stopBits = 0
+        const int stopBits = 0,
+        const int engine = 0,
+        const int receiveBufferSize = 0
     ) -> int;
 
-    auto close() -> int;
+    auto close(
+        const int handle
+    ) -> int;
+
+    auto cancel(
+        const int handle
+    ) -> int;
 
     auto read(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
@@ -41,6 +142,7 @@ namespace UnixSystem {
     ) -> int;
 
     auto readUntil(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
@@ -48,11 +150,142 @@ namespace UnixSystem {
         void* untilChar
     ) -> int;
 
+    auto readLines(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        void* offsets,
+        const int maxLines,
+        const int timeout,
+        const int multiplier,
+        void* untilChar
+    ) -> int;
+
     auto write(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier
     ) -> int;
+
+    auto readv(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    auto writev(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int;
+
+    auto transact(
+        const int handle,
+        void* request,
+        const int requestSize,
+        void* response,
+        const int responseSize,
+        const int timeout,
+        const int multiplier,
+        void* untilChar,
+        void* result,
+        const int resultSize
+    ) -> int;
+
+    auto configureWriteQueue(
+        const int handle,
+        const int capacity,
+        const int coalesceBytes,
+        const int coalesceDelay,
+        const int sliceSize
+    ) -> int;
+
+    auto enqueueWrite(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int priority,
+        const int timeout
+    ) -> int;
+
+    auto flushWriteQueue(
+        const int handle,
+        const int timeout
+    ) -> int;
+
+    auto getWriteQueueStatus(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int;
+
+    auto setPacing(
+        const int handle,
+        const int budget
+    ) -> int;
+
+    auto setCanonicalLines(
+        const int handle,
+        const int enabled
+    ) -> int;
+
+    auto getOutputBacklog(
+        const int handle
+    ) -> int;
+
+    auto drain(
+        const int handle,
+        const int timeout
+    ) -> int;
+
+    auto tuneLatency(
+        const int handle,
+        const int latencyTimer,
+        const int lowLatency,
+        void* sysfsRoot,
+        void* result,
+        const int resultSize
+    ) -> int;
+
+    auto getBaudrate(
+        const int handle
+    ) -> int;
+
+    auto getStats(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int;
+
+    auto mapReceiveRing(
+        const int handle,
+        void* descriptor,
+        const int descriptorSize
+    ) -> int;
+
+    auto getAvailablePorts(
+        void* buffer,
+        const int bufferSize,
+        void* separator
+    ) -> int;
+
+    auto enumeratePorts(
+        void* buffer,
+        const int bufferSize,
+        void* sysfsRoot
+    ) -> int;
+
+    auto portsGeneration() -> int;
+
+    auto waitPortsChanged(
+        const int generation,
+        const int timeout
+    ) -> int;
 }
 #endif
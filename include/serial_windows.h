@@ -1,28 +1,80 @@
 #pragma once
 #if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
 
+#include <algorithm>
+#include <climits>
 #include <string>
 #include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+#ifndef NOMINMAX
+#define NOMINMAX // Keeps windows.h from defining min/max macros that break std::min/std::max
+#endif
 #include <windows.h>
+#include "serial.h"
 #include "status_codes.h"
+#include "engines.h"
+#include "port_table.h"
+#include "port_stats.h"
+#include "transmit_queue.h"
+#include "output_pacing.h"
+#include "pushback_buffer.h"
+#include "delimiter_matcher.h"
+#include "read_until.h"
+#include "read_lines.h"
 
 namespace WindowsSystem {
 
-extern HANDLE hSerialPort;
-extern DCB dcbSerialParams;
-extern COMMTIMEOUTS timeouts;
+struct Port {
+    HANDLE hSerialPort{INVALID_HANDLE_VALUE};
+    DCB dcbSerialParams{0};
+
+    // Comm timeouts of the handle, reads and writes run at the same time and both change them under the mutex
+    std::mutex timeoutsMutex;
+    COMMTIMEOUTS timeouts{0};
+
+    // Serializes the reads of the port, bytes read ahead by readUntil wait in the pushback buffer,
+    // the matcher of the last readUntil delimiter is kept for the next call
+    std::mutex readMutex;
+    PushbackBuffer pushback;
+    DelimiterMatcher delimiterMatcher;
+
+    // Latency and throughput of the calls on the port
+    PortStats stats;
+
+    // Write queue that a writer thread drains, created on first use
+    std::mutex transmitQueueMutex;
+    std::shared_ptr<TransmitQueue> transmitQueue;
+
+    // Milliseconds of output the driver may hold before writes wait, `0` if the port is not paced
+    std::atomic<int> pacingBudget{0};
+
+    ~Port();
+};
+
+extern PortTable<Port> ports;
 
 auto open(
     void* port,
     const int baudrate,
     const int dataBits,
     const int parity = 0,
-    const int stopBits = 0
+    const int stopBits = 0,
+    const int engine = 0,
+    const int receiveBufferSize = 0
 ) -> int;
 
-auto close() -> int;
+auto close(
+    const int handle
+) -> int;
+
+auto cancel(
+    const int handle
+) -> int;
 
 auto read(
+    const int handle,
     void* buffer,
     const int bufferSize,
     const int timeout,
@@ -30,6 +82,7 @@ auto read(
 ) -> int;
 
 auto readUntil(
+    const int handle,
     void* buffer,
     const int bufferSize,
     const int timeout,
@@ -37,19 +90,144 @@ auto readUntil(
     void* untilChar
 ) -> int;
 
+auto readLines(
+    const int handle,
+    void* buffer,
+    const int bufferSize,
+    void* offsets,
+    const int maxLines,
+    const int timeout,
+    const int multiplier,
+    void* untilChar
+) -> int;
+
 auto write(
+    const int handle,
     void* buffer,
     const int bufferSize,
     const int timeout,
     const int multiplier
 ) -> int;
 
+auto readv(
+    const int handle,
+    void* segments,
+    const int segmentCount,
+    const int timeout,
+    const int multiplier
+) -> int;
+
+auto writev(
+    const int handle,
+    void* segments,
+    const int segmentCount,
+    const int timeout,
+    const int multiplier
+) -> int;
+
+auto transact(
+    const int handle,
+    void* request,
+    const int requestSize,
+    void* response,
+    const int responseSize,
+    const int timeout,
+    const int multiplier,
+    void* untilChar,
+    void* result,
+    const int resultSize
+) -> int;
+
+auto configureWriteQueue(
+    const int handle,
+    const int capacity,
+    const int coalesceBytes,
+    const int coalesceDelay,
+    const int sliceSize
+) -> int;
+
+auto enqueueWrite(
+    const int handle,
+    void* buffer,
+    const int bufferSize,
+    const int priority,
+    const int timeout
+) -> int;
+
+auto flushWriteQueue(
+    const int handle,
+    const int timeout
+) -> int;
+
+auto getWriteQueueStatus(
+    const int handle,
+    void* buffer,
+    const int bufferSize
+) -> int;
+
+auto setPacing(
+    const int handle,
+    const int budget
+) -> int;
+
+auto setCanonicalLines(
+    const int handle,
+    const int enabled
+) -> int;
+
+auto getOutputBacklog(
+    const int handle
+) -> int;
+
+auto drain(
+    const int handle,
+    const int timeout
+) -> int;
+
+auto tuneLatency(
+    const int handle,
+    const int latencyTimer,
+    const int lowLatency,
+    void* sysfsRoot,
+    void* result,
+    const int resultSize
+) -> int;
+
+auto getBaudrate(
+    const int handle
+) -> int;
+
+auto getStats(
+    const int handle,
+    void* buffer,
+    const int bufferSize
+) -> int;
+
+auto mapReceiveRing(
+    const int handle,
+    void* descriptor,
+    const int descriptorSize
+) -> int;
+
 auto getAvailablePorts(
     void* buffer,
     const int bufferSize,
     void* separator
 ) -> int;
 
+auto enumeratePorts(
+    void* buffer,
+    const int bufferSize,
+    void* sysfsRoot
+) -> int;
+
+auto portsGeneration() -> int;
+
+auto waitPortsChanged(
+    const int generation,
+    const int timeout
+) -> int;
+
 }
 
 #endif
@@ -0,0 +1,161 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <span>
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+
+/**
+* @brief Lock free single producer/single consumer byte ring.
+*
+* The producer owns `tail`, the consumer owns `head`, each side keeps a cached
+* copy of the other index and only reloads it when the ring looks full or
+* empty. Both indices and their caches live on separate cache lines, so the
+* two threads never write to the same line. Indices are 32 bit, grow without
+* bound and are masked on access, the capacity is always a power of two.
+*
+* Control block and data share one pinned allocation with a fixed layout (see
+* the offsets below), so a consumer outside of C++ (the Deno side maps it with
+* `Deno.UnsafePointerView`) can take over the consumer role.
+*/
+class SpscRing {
+    struct alignas(64) Producer {
+        std::atomic<std::uint32_t> tail{0};
+        std::uint32_t cachedHead{0};
+    };
+
+    struct alignas(64) Consumer {
+        std::atomic<std::uint32_t> head{0};
+        std::uint32_t cachedTail{0};
+    };
+
+    struct Control {
+        Producer producer;
+        Consumer consumer;
+        alignas(64) std::uint32_t capacity{0};
+    };
+
+public:
+    static constexpr std::size_t cacheLineSize = 64;
+    static constexpr std::size_t maxCapacity = std::size_t{1} << 30;
+
+    // Byte offsets into the block returned by `data()`
+    static constexpr std::size_t tailOffset = 0;
+    static constexpr std::size_t headOffset = cacheLineSize;
+    static constexpr std::size_t capacityOffset = 2 * cacheLineSize;
+    static constexpr std::size_t dataOffset = sizeof(Control);
+
+    explicit SpscRing(std::size_t capacity)
+        : capacity(static_cast<std::uint32_t>(std::bit_ceil(std::clamp<std::size_t>(capacity, cacheLineSize, maxCapacity)))),
+          mask(this->capacity - 1),
+          block(static_cast<char*>(::operator new[](dataOffset + this->capacity, std::align_val_t(cacheLineSize)))),
+          control(new (block) Control()),
+          buffer(block + dataOffset) {
+        control->capacity = this->capacity;
+
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+        // Best effort, the ring works unpinned as well
+        pinned = mlock(block, dataOffset + this->capacity) == 0;
+#endif
+    }
+
+    ~SpscRing() {
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+        if (pinned) {
+            munlock(block, dataOffset + capacity);
+        }
+#endif
+        control->~Control();
+        ::operator delete[](block, std::align_val_t(cacheLineSize));
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    auto operator=(const SpscRing&) -> SpscRing& = delete;
+
+    auto size() const -> std::size_t {
+        return capacity;
+    }
+
+    /**
+    * @brief Returns the start of the control block, the data follows at `dataOffset`.
+    */
+    auto data() const -> char* {
+        return block;
+    }
+
+    /**
+    * @brief Producer side: returns the contiguous free space, which is empty if the ring is full.
+    */
+    auto prepare() -> std::span<char> {
+        Producer &producer = control->producer;
+        const std::uint32_t tail = producer.tail.load(std::memory_order_relaxed);
+
+        if (tail - producer.cachedHead == capacity) {
+            producer.cachedHead = control->consumer.head.load(std::memory_order_acquire);
+        }
+
+        const std::uint32_t free = capacity - (tail - producer.cachedHead);
+        const std::uint32_t offset = tail & mask;
+
+        return {buffer + offset, std::min(free, capacity - offset)};
+    }
+
+    /**
+    * @brief Producer side: publishes `size` bytes that were written into the space returned by `prepare`.
+    */
+    auto commit(std::size_t size) -> void {
+        std::atomic<std::uint32_t> &tail = control->producer.tail;
+        tail.store(tail.load(std::memory_order_relaxed) + static_cast<std::uint32_t>(size), std::memory_order_release);
+    }
+
+    /**
+    * @brief Consumer side: returns the number of bytes that can be read.
+    */
+    auto readable() -> std::size_t {
+        Consumer &consumer = control->consumer;
+        const std::uint32_t head = consumer.head.load(std::memory_order_relaxed);
+
+        if (consumer.cachedTail == head) {
+            consumer.cachedTail = control->producer.tail.load(std::memory_order_acquire);
+        }
+
+        return consumer.cachedTail - head;
+    }
+
+    /**
+    * @brief Consumer side: moves up to `size` bytes into `destination`.
+    * @return Returns the number of bytes moved
+    */
+    auto read(char* destination, std::size_t size) -> std::size_t {
+        const std::uint32_t count = static_cast<std::uint32_t>(std::min(size, readable()));
+        std::atomic<std::uint32_t> &head = control->consumer.head;
+        const std::uint32_t position = head.load(std::memory_order_relaxed);
+        const std::uint32_t offset = position & mask;
+        const std::uint32_t first = std::min(count, capacity - offset);
+
+        memcpy(destination, buffer + offset, first);
+        memcpy(destination + first, buffer, count - first);
+
+        head.store(position + count, std::memory_order_release);
+
+        return count;
+    }
+
+private:
+    const std::uint32_t capacity;
+    const std::uint32_t mask;
+    char *const block;
+    Control *const control;
+    char *const buffer;
+    bool pinned{false};
+};
+
+static_assert(SpscRing::dataOffset == 3 * SpscRing::cacheLineSize, "The ring layout is part of the ABI");
@@ -0,0 +1,19 @@
+#pragma once
+
+// The status codes without the `status` macro of `status_codes.h`, for headers that C++ users include
+enum class StatusCodes {
+    SUCCESS = 0,
+    CLOSE_HANDLE_ERROR = -1,
+    INVALID_HANDLE_ERROR = -2,
+    READ_ERROR = -3,
+    WRITE_ERROR = -4,
+    GET_PROPERTY_ERROR = -5,
+    SET_PROPERTY_ERROR = -6,
+    SET_TIMEOUT_ERROR = -7,
+    BUFFER_ERROR = -8,
+    NOT_FOUND_ERROR = -9,
+    PORT_LIMIT_ERROR = -10,
+    NOT_SUPPORTED_ERROR = -11,
+    BUSY_ERROR = -12,
+    CANCELLED_ERROR = -13
+};
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "serial.h"
+#include "priorities.h"
+
+/**
+* @brief Bounded queue of outgoing bytes that a writer thread of the port hands to the system.
+*
+* Producers copy their bytes into a ring and return right away. A full ring
+* makes them wait up to their timeout, which is the backpressure. The writer
+* thread waits until `coalesceBytes` are queued or the oldest byte has waited
+* for `coalesceDelay`, then writes everything that is queued at once. Bursts of
+* small frames collapse into a few system calls, while a lone frame is delayed
+* by at most `coalesceDelay`.
+*
+* Bytes have one of two priorities. Bulk bytes go out in slices of at most
+* `sliceSize` bytes, and the next slice only once the kernel holds no more than
+* one slice of output. Urgent bytes have a ring of their own, skip coalescing
+* and go out at the next slice boundary. An urgent frame therefore waits behind
+* at most two slices, the one being written and the one the kernel holds,
+* however much bulk is queued. A backlog limit above one slice lets the kernel
+* hold that many bytes instead, which keeps fast lines busy.
+*
+* Bytes that are still queued when the queue is destroyed are dropped, `flush`
+* waits for them first.
+*/
+class TransmitQueue {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // Writes up to `size` bytes and returns the number of bytes written, `0` on timeout or a negative status code
+    using Writer = std::function<int(const char* data, int size)>;
+
+    // Returns the number of bytes the kernel holds for transmission or `-1` if that is unknown
+    using Pending = std::function<int()>;
+
+    static constexpr std::size_t defaultCapacity = 64 * 1024;
+    static constexpr std::size_t defaultCoalesceBytes = 512;
+    static constexpr std::chrono::microseconds defaultCoalesceDelay{1000};
+    static constexpr std::size_t defaultSliceSize = 256;
+
+    // Urgent frames are meant to be short, their ring is small and fixed
+    static constexpr std::size_t urgentCapacity = 4096;
+
+    TransmitQueue(
+        Writer writer,
+        Pending pending,
+        std::size_t capacity,
+        std::size_t coalesceBytes,
+        std::chrono::microseconds coalesceDelay,
+        std::size_t sliceSize
+    );
+    ~TransmitQueue();
+
+    TransmitQueue(const TransmitQueue&) = delete;
+    auto operator=(const TransmitQueue&) -> TransmitQueue& = delete;
+
+    /**
+    * @brief Copies the bytes into the ring of their priority, all of them or none.
+    * @param timeout Time to wait for room in `ms`, a negative timeout waits forever
+    * @return Returns the number of bytes queued, `0` if there was no room in time or a negative status code
+    */
+    auto push(const char* data, std::size_t size, Priorities priority, int timeout) -> int;
+
+    /**
+    * @brief Waits until the writer has handed every queued byte to the system.
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever
+    * @return Returns the number of bytes that are still queued
+    */
+    auto flush(int timeout) -> std::size_t;
+
+    /**
+    * @brief Lets the kernel hold up to `bytes` of output before the next bulk slice, but never less than one slice.
+    */
+    auto setBacklogLimit(std::size_t bytes) -> void;
+
+    /**
+    * @brief Returns `true` if no byte is queued or being written.
+    */
+    auto idle() -> bool;
+
+    /**
+    * @brief Returns the depth, the capacity and the counters of the queue.
+    */
+    auto snapshot() -> WriteQueueStatus;
+
+private:
+    struct Ring {
+        explicit Ring(std::size_t capacity) : data(capacity) {}
+
+        auto room() const -> std::size_t {
+            return data.size() - size;
+        }
+
+        auto put(const char* source, std::size_t count) -> void;
+        auto take(char* destination, std::size_t count) -> void;
+
+        std::vector<char> data;
+        std::size_t head{0};
+        std::size_t size{0};
+        Clock::time_point oldest;
+    };
+
+    auto run() -> void;
+    auto depth() const -> std::size_t;
+
+    Writer writer;
+    Pending pending;
+    std::size_t coalesceBytes;
+    std::chrono::microseconds coalesceDelay;
+    std::size_t sliceSize;
+    std::atomic<std::size_t> backlogLimit{0};
+
+    std::mutex mutex;
+    std::condition_variable queued;
+    std::condition_variable room;
+    std::condition_variable drained;
+
+    // `inFlight` bytes were taken by the writer and are not written yet
+    Ring bulk;
+    Ring urgent;
+    std::size_t inFlight{0};
+
+    std::uint64_t highWater{0};
+    std::uint64_t bytesQueued{0};
+    std::uint64_t bytesWritten{0};
+    std::uint64_t writes{0};
+    std::uint64_t rejected{0};
+    std::uint64_t errors{0};
+    std::uint64_t urgentBytes{0};
+    std::uint64_t maxUrgentLatency{0};
+
+    std::atomic<bool> stopping{false};
+    std::thread thread;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#if defined(__linux__)
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace UnixSystem {
+
+    /**
+    * @brief Lets `cancel` wake every wait that is in progress on a port.
+    *
+    * Waits in `poll` watch the eventfd of the cancellation next to the tty,
+    * waits on a condition variable check `Wait::cancelled` in their predicate.
+    * A cancel bumps the generation, signals the eventfd and returns once every
+    * wait that was in progress has ended. Only then the eventfd is reset, waits
+    * that start meanwhile are held back until it is, so no wait ever sees the
+    * signal of a cancel that was meant for an earlier one.
+    */
+    class Cancellation {
+    public:
+        Cancellation();
+        ~Cancellation();
+
+        Cancellation(const Cancellation&) = delete;
+        auto operator=(const Cancellation&) -> Cancellation& = delete;
+
+        /**
+        * @brief Registers a wait for as long as it lives.
+        * It has to be created before any lock that the `wake` callback of `cancel` takes.
+        */
+        class Wait {
+        public:
+            explicit Wait(Cancellation &cancellation);
+            ~Wait();
+
+            Wait(const Wait&) = delete;
+            auto operator=(const Wait&) -> Wait& = delete;
+
+            auto cancelled() const -> bool;
+
+        private:
+            Cancellation &cancellation;
+            std::uint64_t generation;
+        };
+
+        /**
+        * @brief Returns the eventfd that becomes readable on cancel or `-1` if there is none.
+        */
+        auto fd() const -> int;
+
+        /**
+        * @brief Wakes every wait that is in progress and returns once all of them have ended.
+        * @param wake Wakes the waits on condition variables
+        * @return Returns `false` if the cancellation has no eventfd
+        */
+        auto cancel(const std::function<void()> &wake) -> bool;
+
+    private:
+        int eventFd{-1};
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        std::atomic<std::uint64_t> generation{0};
+        int waits{0};
+        bool cancelling{false};
+    };
+}
+#endif
@@ -0,0 +1,39 @@
+#pragma once
+#if defined(__linux__)
+#include <filesystem>
+#include <string>
+
+namespace UnixSystem {
+
+    /*
+    * USB serial adapters such as FTDI collect received bytes for `latency_timer`
+    * milliseconds (16 by default) before they hand them to the host, which puts a
+    * floor under every round trip. The attribute lives on the usb-serial device the
+    * tty belongs to, `<sysfs>/class/tty/<tty>/device/latency_timer`. The sysfs root
+    * is a parameter, so the lookup also works against a fake tree.
+    */
+
+    /**
+    * @brief Resolves the tty (following links like `/dev/serial/by-id/...`) to the `latency_timer` attribute of its device.
+    * @return Returns the path of the attribute or an empty path if the device has none
+    */
+    auto latencyTimerPath(const std::filesystem::path &sysfsRoot, const std::string &ttyPath) -> std::filesystem::path;
+
+    /**
+    * @brief Reads the latency timer in milliseconds.
+    * @return Returns the latency timer or `-1` if it can not be read
+    */
+    auto readLatencyTimer(const std::filesystem::path &attribute) -> int;
+
+    /**
+    * @brief Writes the latency timer in milliseconds, which usually needs write access to sysfs.
+    */
+    auto writeLatencyTimer(const std::filesystem::path &attribute, int milliseconds) -> bool;
+
+    /**
+    * @brief Sets `ASYNC_LOW_LATENCY` on the serial driver with `TIOCSSERIAL`.
+    * @return Returns `1` if the flag is set afterwards, `0` if the driver refused it or `-1` if the tty is no serial driver
+    */
+    auto setLowLatency(int fd) -> int;
+}
+#endif
@@ -0,0 +1,78 @@
+#pragma once
+#if defined(__linux__)
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "serial.h"
+
+namespace UnixSystem {
+
+    /**
+    * @brief Cached list of the serial ports that follows hotplug events.
+    *
+    * The ports are described once, afterwards an inotify watch on the device
+    * directory reports every tty node that appears or disappears, and only that
+    * port gets described again or dropped. Queries hand out the current list
+    * without touching the file system. Every change bumps the generation, so a
+    * caller can wait for the next change instead of polling the list.
+    */
+    class PortRegistry {
+    public:
+        using Ports = std::shared_ptr<const std::vector<PortInfo>>;
+
+        /**
+        * @brief Returns the registry of `/dev` and `/sys` or `nullptr` if inotify is not available, the watch starts on first use.
+        */
+        static auto instance() -> PortRegistry*;
+
+        PortRegistry(std::filesystem::path sysfsRoot, std::filesystem::path devRoot);
+        ~PortRegistry();
+
+        PortRegistry(const PortRegistry&) = delete;
+        auto operator=(const PortRegistry&) -> PortRegistry& = delete;
+
+        /**
+        * @brief Returns `false` if the watch could not be set up.
+        */
+        auto watching() const -> bool;
+
+        /**
+        * @brief Returns the current ports, sorted by path. The list never changes, a change replaces it.
+        */
+        auto ports() -> Ports;
+
+        auto generation() -> std::uint64_t;
+
+        /**
+        * @brief Waits until the generation differs from `known` or the timeout expires.
+        * @param timeout Time to wait in `ms`, a negative timeout waits forever
+        * @return Returns the current generation
+        */
+        auto waitForChange(std::uint64_t known, int timeout) -> std::uint64_t;
+
+    private:
+        auto run() -> void;
+        auto rescan() -> void;
+        auto update(const std::string &name, bool added) -> void;
+
+        std::filesystem::path sysfsRoot;
+        std::filesystem::path devRoot;
+
+        int inotifyFd{-1};
+        int stopFd{-1};
+
+        std::mutex mutex;
+        std::condition_variable changed;
+        Ports current;
+        std::uint64_t currentGeneration{0};
+
+        std::thread thread;
+    };
+}
+#endif
@@ -0,0 +1,32 @@
+#pragma once
+#if defined(__linux__)
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "serial.h"
+
+namespace UnixSystem {
+
+    /*
+    * Every tty of the system has an entry in `<sysfs>/class/tty`, those that
+    * belong to hardware have a `device` link with a bound driver. USB adapters
+    * sit below their USB interface (`bInterfaceNumber`), which sits below the
+    * USB device (`idVendor`, `idProduct`, `serial`). The sysfs root is a
+    * parameter, so the enumeration also works against a fake tree.
+    */
+
+    /**
+    * @brief Describes the tty `name`, whose device node lives in `devRoot`.
+    * Legacy UARTs (`serial8250`) are listed for every possible port, only those the probe finds are kept.
+    * @return Returns the description or nothing if the tty is no serial port
+    */
+    auto describePort(const std::filesystem::path &sysfsRoot, const std::filesystem::path &devRoot, const std::string &name) -> std::optional<PortInfo>;
+
+    /**
+    * @brief Describes every serial port the system has, sorted by path.
+    */
+    auto describePorts(const std::filesystem::path &sysfsRoot, const std::filesystem::path &devRoot) -> std::vector<PortInfo>;
+}
+#endif
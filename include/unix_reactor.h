@@ -0,0 +1,90 @@
+#pragma once
+#if defined(__linux__)
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+
+namespace UnixSystem {
+
+    /**
+    * @brief Event loop that services the file descriptors of every port on a single thread.
+    *
+    * File descriptors are registered with one epoll instance and their readiness
+    * is dispatched to the callback given at registration. Deadlines are kept in an
+    * ordered timer map, the earliest one bounds the `epoll_wait` timeout. Callbacks
+    * always run on the reactor thread and never while one of its locks is held, so
+    * they may register, modify or remove descriptors and timers themselves.
+    */
+    class Reactor {
+    public:
+        using Clock = std::chrono::steady_clock;
+        using EventCallback = std::function<void(std::uint32_t events)>;
+        using TimerCallback = std::function<void()>;
+        using TimerId = std::pair<Clock::time_point, std::uint64_t>;
+
+        /**
+        * @brief Returns the process wide reactor, its thread is started on first use.
+        */
+        static auto instance() -> Reactor&;
+
+        Reactor();
+        ~Reactor();
+
+        Reactor(const Reactor&) = delete;
+        auto operator=(const Reactor&) -> Reactor& = delete;
+
+        /**
+        * @brief Registers the file descriptor for the epoll events.
+        * @return Returns the registration id or `0` if the registration fails
+        */
+        auto add(int fd, std::uint32_t events, EventCallback onEvents) -> std::uint64_t;
+
+        /**
+        * @brief Changes the epoll events a registration is waiting for.
+        */
+        auto modify(std::uint64_t id, std::uint32_t events) -> bool;
+
+        /**
+        * @brief Removes the registration. A dispatch that is already under way may still
+        * call the callback once, so callbacks must not own the port they serve.
+        */
+        auto remove(std::uint64_t id) -> void;
+
+        /**
+        * @brief Calls the callback on the reactor thread as soon as the deadline has passed.
+        */
+        auto addTimer(Clock::time_point deadline, TimerCallback onExpire) -> TimerId;
+
+        /**
+        * @brief Removes the timer if it has not expired yet.
+        */
+        auto cancelTimer(const TimerId &id) -> void;
+
+    private:
+        struct Registration {
+            int fd;
+            EventCallback onEvents;
+        };
+
+        auto run() -> void;
+        auto wake() -> void;
+
+        int epollFd{-1};
+        int wakeFd{-1};
+        bool stopping{false};
+
+        std::mutex mutex;
+        std::uint64_t nextId{1};
+        std::unordered_map<std::uint64_t, Registration> registrations;
+        std::map<TimerId, TimerCallback> timers;
+
+        std::thread thread;
+    };
+}
+#endif
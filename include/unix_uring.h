@@ -0,0 +1,172 @@
+#pragma once
+#if defined(__linux__)
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <sys/uio.h>
+
+#include "unix_cancellation.h"
+
+struct io_uring_sqe;
+
+namespace UnixSystem {
+
+    /**
+    * @brief Process wide io_uring instance that carries the reads and writes of every port.
+    *
+    * Submissions of all callers go into one submission queue, so operations of
+    * different ports that are queued at the same time share a single
+    * `io_uring_enter`. A completion thread reaps the completion queue and wakes
+    * the callers. Every operation can be linked to an `IORING_OP_LINK_TIMEOUT`,
+    * which lets the kernel cancel it once its deadline has passed. Operations
+    * that are registered with the `Operations` of their port are aborted inside
+    * the kernel by `cancel`, so a waiting read needs no poll of its own.
+    *
+    * A pool of fixed buffers is registered with the ring once. Ports borrow
+    * slots of that pool, so their transfers skip pinning the user pages on every
+    * operation.
+    */
+    class Uring {
+    public:
+        // Number of fixed buffer slots and bytes per slot that get registered with the ring
+        static constexpr std::size_t bufferCount = 64;
+        static constexpr std::size_t bufferSize = 16 * 1024;
+
+        /**
+        * @brief The operations of one port that are in flight, so `cancel` can reach them.
+        */
+        class Operations {
+        private:
+            friend class Uring;
+
+            std::mutex mutex;
+            std::vector<std::uint64_t> inFlight;
+        };
+
+        /**
+        * @brief Returns the process wide ring or `nullptr` if io_uring is not available.
+        */
+        static auto instance() -> Uring*;
+
+        ~Uring();
+
+        Uring(const Uring&) = delete;
+        auto operator=(const Uring&) -> Uring& = delete;
+
+        /**
+        * @brief Borrows a registered buffer slot.
+        * @return Returns the index of the slot or `-1` if every slot is in use
+        */
+        auto acquireBuffer() -> int;
+
+        /**
+        * @brief Returns a registered buffer slot to the pool.
+        */
+        auto releaseBuffer(int index) -> void;
+
+        /**
+        * @brief Returns the memory of a registered buffer slot.
+        */
+        auto buffer(int index) -> char*;
+
+        /**
+        * @brief Reads into `data`, which has to be the memory of the slot `bufferIndex` or any memory if `bufferIndex` is `-1`.
+        * @param timeout Kernel side deadline of the read, no deadline if it is zero
+        * @param operations The operations of the port `cancel` aborts, the read can not be cancelled without them
+        * @param wait The wait of the caller, the read is not submitted at all if it got cancelled already
+        * @return Returns the number of bytes read, `0` if the deadline passed first or `-errno`
+        */
+        auto read(int fd, void* data, unsigned size, int bufferIndex, std::chrono::milliseconds timeout, Operations* operations = nullptr, const Cancellation::Wait* wait = nullptr) -> int;
+
+        /**
+        * @brief Writes from `data`, which has to be the memory of the slot `bufferIndex` or any memory if `bufferIndex` is `-1`.
+        * @param timeout Kernel side deadline of the write, no deadline if it is zero
+        * @param operations The operations of the port `cancel` aborts, the write can not be cancelled without them
+        * @param wait The wait of the caller, the write is not submitted at all if it got cancelled already
+        * @return Returns the number of bytes written, `0` if the deadline passed first or `-errno`
+        */
+        auto write(int fd, const void* data, unsigned size, int bufferIndex, std::chrono::milliseconds timeout, Operations* operations = nullptr, const Cancellation::Wait* wait = nullptr) -> int;
+
+        /**
+        * @brief Scatters a read over the segments, which stay in use until the read completed.
+        * @param timeout Kernel side deadline of the read, no deadline if it is zero
+        * @param operations The operations of the port `cancel` aborts, the read can not be cancelled without them
+        * @param wait The wait of the caller, the read is not submitted at all if it got cancelled already
+        * @return Returns the number of bytes read, `0` if the deadline passed first or `-errno`
+        */
+        auto readv(int fd, const iovec* segments, unsigned count, std::chrono::milliseconds timeout, Operations* operations = nullptr, const Cancellation::Wait* wait = nullptr) -> int;
+
+        /**
+        * @brief Gathers a write from the segments, which stay in use until the write completed.
+        * @param timeout Kernel side deadline of the write, no deadline if it is zero
+        * @param operations The operations of the port `cancel` aborts, the write can not be cancelled without them
+        * @param wait The wait of the caller, the write is not submitted at all if it got cancelled already
+        * @return Returns the number of bytes written, `0` if the deadline passed first or `-errno`
+        */
+        auto writev(int fd, const iovec* segments, unsigned count, std::chrono::milliseconds timeout, Operations* operations = nullptr, const Cancellation::Wait* wait = nullptr) -> int;
+
+        /**
+        * @brief Aborts every operation of the port that is in flight with `IORING_OP_ASYNC_CANCEL`, they complete with `-ECANCELED` or `-EINTR`.
+        */
+        auto cancel(Operations &operations) -> void;
+
+    private:
+        // Lives on the stack of the submitter, the completion thread only touches it while holding `mutex`
+        struct Request {
+            std::mutex mutex;
+            std::condition_variable completed;
+            bool done{false};
+            int result{0};
+        };
+
+        Uring() = default;
+
+        auto setup() -> bool;
+        auto submit(std::uint8_t opcode, int fd, const void* data, unsigned size, int bufferIndex, std::chrono::milliseconds timeout, Operations* operations, const Cancellation::Wait* wait) -> int;
+        auto reap() -> void;
+
+        // Queue `needed` entries, the caller holds `submitMutex` and publishes the tail afterwards
+        auto reserve(unsigned needed) -> unsigned;
+        auto entry(unsigned &tail) -> io_uring_sqe&;
+        auto publish(unsigned tail) -> void;
+
+        // Submits the entries up to `tail` unless another caller already did
+        auto enter(unsigned tail) -> void;
+
+        int ringFd{-1};
+
+        // Submission queue, guarded by `submitMutex`
+        std::mutex submitMutex;
+        void* submissionRing{nullptr};
+        std::size_t submissionRingSize{0};
+        unsigned *submissionHead{nullptr};
+        unsigned *submissionTail{nullptr};
+        unsigned submissionMask{0};
+        unsigned *submissionArray{nullptr};
+        void* submissionEntries{nullptr};
+        std::size_t submissionEntriesSize{0};
+
+        // Completion queue, only touched by the completion thread
+        void* completionRing{nullptr};
+        std::size_t completionRingSize{0};
+        unsigned *completionHead{nullptr};
+        unsigned *completionTail{nullptr};
+        unsigned completionMask{0};
+        void* completionEntries{nullptr};
+
+        // Registered buffer pool
+        std::mutex bufferMutex;
+        void* bufferMemory{nullptr};
+        std::vector<int> freeBuffers;
+        bool buffersRegistered{false};
+
+        std::atomic<bool> stopping{false};
+        std::thread completionThread;
+    };
+}
+#endif
@@ -1,15 +1,29 @@
 import { checkForErrorCode } from "./check_for_error_code.ts";
+import { CompletionDispatcher } from "./completion_dispatcher.ts";
 import { dataBits } from "./constants/data_bits.ts";
+import { engines } from "./constants/engines.ts";
 import { parity } from "./constants/parity.ts";
+import { priorities } from "./constants/priorities.ts";
 import { stopBits } from "./constants/stop_bits.ts";
 import { decode } from "./decode.ts";
+import { PortInfo } from "./interfaces/port_info.d.ts";
 import { Ports } from "./interfaces/ports.ts";
 import { SerialFunctions } from "./interfaces/serial_functions.d.ts";
+import { LatencyTuning } from "./interfaces/latency_tuning.d.ts";
+import { PortStatistics } from "./interfaces/port_statistics.d.ts";
 import { SerialOptions } from "./interfaces/serial_options.d.ts";
+import { TransactResult } from "./interfaces/transact_result.d.ts";
+import { WriteQueueStatus } from "./interfaces/write_queue_status.d.ts";
 import { loadDL } from "./load_dl.ts";
+import { decodePortInfo, portInfoSize } from "./port_info.ts";
+import { decodeStatistics, statisticsSize } from "./port_statistics.ts";
+import { ReceiveRing } from "./receive_ring.ts";
+import { segmentsOf } from "./segments_of.ts";
+import { decodeWriteQueueStatus, writeQueueStatusSize } from "./write_queue_status.ts";
 
 export class Serial {
     private _isOpen : boolean;
+    private _handle : number;
     private _dl : SerialFunctions;
 
     /**
@@ -17,6 +31,7 @@ export class Serial {
      */
     constructor() {
         this._isOpen = false;
+        this._handle = 0;
         this._dl = loadDL('./lib/dls', Deno.build.os);
     }
 
@@ -32,7 +47,8 @@ export class Serial {
      * Opens the serial connection.
      * @param {string|Ports} port The port to connect
      * @param {number} baudrate The baudrate
-     * @param {SerialOptions} serialOptions Additional options for the serial connection (`data bits`, `parity`, `stop bits`)
+     * @param {SerialOptions} serialOptions Additional options for the serial connection (`data bits`, `parity`, `stop bits`, `engine`, `receive buffer size`, `latency timer`)
+     * @returns {number} Returns the handle of the opened port
      */
     open(
         port : string | Ports,
@@ -46,13 +62,20 @@ export class Serial {
             baudrate,
             serialOptions?.dataBits || dataBits.EIGHT,
             serialOptions?.parity || parity.NONE,
-            serialOptions?.stopBits || stopBits.ONE
+            serialOptions?.stopBits || stopBits.ONE,
+            serialOptions?.engine || engines.BLOCKING,
+            serialOptions?.receiveBufferSize || 0
         );
         
         checkForErrorCode(status);
 
+        this._handle = status;
         this._isOpen = true;
 
+        if (serialOptions?.latencyTimer && Deno.build.os == 'linux') {
+            this.tuneLatency(serialOptions.latencyTimer);
+        }
+
         return status;
     }
 
@@ -60,15 +83,26 @@ export class Serial {
      * Closes the serial connection.
      */
     close() : number {
-        const status = this._dl.close();
+        const status = this._dl.close(this._handle);
 
         checkForErrorCode(status);
 
+        this._handle = 0;
         this._isOpen = false;
 
         return status;
     }
 
+    /**
+     * Wake every call that is waiting on the serial connection, e.g. from a worker, they fail with `CANCELLED_ERROR`.
+     * Calls that start afterwards are not affected.
+     */
+    cancel() : void {
+        const status = this._dl.cancel(this._handle);
+
+        checkForErrorCode(status);
+    }
+
     /**
      * Read data from serial connection.
      * @param {Uint8Array} buffer Buffer to read the bytes into
@@ -84,6 +118,7 @@ export class Serial {
         multiplier = 10
     ) : number {
         const status = this._dl.read(
+            this._handle,
             buffer,
             bytes,
             timeout,
@@ -97,6 +132,7 @@ export class Serial {
 
     /**
      * Read data from serial connection until a linebreak (`\n`) gets send.
+     * After `setCanonicalLines(true)` the tty may split the lines itself, see there for its limits on long lines.
      * @param {Uint8Array} buffer Buffer to read the bytes into
      * @param {number} bytes The number of bytes to read
      * @param {number} timeout The timeout in `ms`
@@ -112,6 +148,7 @@ export class Serial {
         searchString = '',
     ) : number {
         const status = this._dl.readUntil(
+            this._handle,
             buffer,
             bytes,
             timeout,
@@ -123,6 +160,41 @@ export class Serial {
 
         return status
     }
+
+    /**
+     * Read every complete line that has been received in one call, instead of calling `readUntil` once per line.
+     * Waits until the first line is complete, later lines are only taken if they already arrived.
+     * An unfinished trailing line is kept for the next read.
+     * @param {Uint8Array} buffer Buffer to read the lines into
+     * @param {Uint32Array} offsets Receives the start and end offset of every line in the buffer, the end excludes the delimiter
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @param {string} searchString The string that ends a line
+     * @returns {number} Returns number of lines read, line `i` is `buffer.subarray(offsets[2 * i], offsets[2 * i + 1])`
+     */
+    readLines(
+        buffer : Uint8Array,
+        offsets : Uint32Array,
+        timeout = 0,
+        multiplier = 10,
+        searchString = '\n',
+    ) : number {
+        const status = this._dl.readLines(
+            this._handle,
+            buffer,
+            buffer.byteLength,
+            offsets,
+            offsets.length >> 1,
+            timeout,
+            multiplier,
+            searchString
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
     /**
      * Write data to serial connection.
      * @param {Uint8Array} buffer The data to write/send
@@ -138,6 +210,7 @@ export class Serial {
         multiplier = 10
     ) : number {
         const status = this._dl.write(
+            this._handle,
             buffer,
             bytes,
             timeout,
@@ -149,8 +222,423 @@ export class Serial {
         return status
     }
 
+    /**
+     * Read data from serial connection into several buffers, each buffer is filled before the next one.
+     * @param {Uint8Array[]} buffers Buffers to read the bytes into
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @returns {number} Returns number of bytes read
+     */
+    readv(
+        buffers : Uint8Array[],
+        timeout = 0,
+        multiplier = 10
+    ) : number {
+        const status = this._dl.readv(
+            this._handle,
+            segmentsOf(buffers),
+            buffers.length,
+            timeout,
+            multiplier
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Write several buffers to serial connection without joining them first.
+     * @param {Uint8Array[]} buffers The data to write/send, in order
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @returns {number} Returns number of bytes written
+     */
+    writev(
+        buffers : Uint8Array[],
+        timeout = 0,
+        multiplier = 10
+    ) : number {
+        const status = this._dl.writev(
+            this._handle,
+            segmentsOf(buffers),
+            buffers.length,
+            timeout,
+            multiplier
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Write a request and read its response in a single call.
+     * The response is read until the search string gets send, `responseBytes` were read or its deadline has passed.
+     * @param {Uint8Array} request The data to write/send
+     * @param {number} requestBytes The number of bytes to write
+     * @param {Uint8Array} response Buffer to read the response into
+     * @param {number} responseBytes The number of bytes to read
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @param {string} searchString A string that ends the response, the length and the timeout stop an empty string
+     * @returns {TransactResult} Returns the number of bytes written and read
+     */
+    transact(
+        request : Uint8Array,
+        requestBytes : number,
+        response : Uint8Array,
+        responseBytes : number,
+        timeout = 0,
+        multiplier = 10,
+        searchString = '',
+    ) : TransactResult {
+        const result = new Int32Array(2);
+
+        const status = this._dl.transact(
+            this._handle,
+            request,
+            requestBytes,
+            response,
+            responseBytes,
+            timeout,
+            multiplier,
+            searchString,
+            new Uint8Array(result.buffer)
+        );
+
+        checkForErrorCode(status);
+
+        return {
+            bytesWritten: result[0],
+            bytesRead: result[1]
+        };
+    }
+
+    /**
+     * Set up the write queue of the serial connection, which `enqueueWrite` otherwise creates with the defaults.
+     * @param {number} capacity The number of bytes the queue holds before `enqueueWrite` has to wait
+     * @param {number} coalesceBytes The number of queued bytes that are written right away
+     * @param {number} coalesceDelay The time in `µs` a queued byte waits for more to write them together
+     * @param {number} sliceSize The most bulk bytes that are written at once, an urgent frame waits behind at most two slices
+     */
+    configureWriteQueue(
+        capacity = 65536,
+        coalesceBytes = 512,
+        coalesceDelay = 1000,
+        sliceSize = 256
+    ) : void {
+        const status = this._dl.configureWriteQueue(
+            this._handle,
+            capacity,
+            coalesceBytes,
+            coalesceDelay,
+            sliceSize
+        );
+
+        checkForErrorCode(status);
+    }
+
+    /**
+     * Queue data to write/send and return before it is written, small writes that follow each other closely are sent together.
+     * @param {Uint8Array} buffer The data to queue
+     * @param {number} bytes The number of bytes to queue
+     * The call is synchronous, waiting for room blocks the event loop. By default it does not wait, `0` tells to retry later,
+     * e.g. after `flushWriteQueue`.
+     * @param {number} timeout The time to wait for room in the queue in `ms`, `0` does not wait and a negative timeout waits forever
+     * @param {number} priority `priorities.URGENT` sends the data ahead of the queued bulk data
+     * @returns {number} Returns the number of bytes queued, `0` if there was no room in time
+     */
+    enqueueWrite(
+        buffer : Uint8Array,
+        bytes : number,
+        timeout = 0,
+        priority : number = priorities.BULK
+    ) : number {
+        const status = this._dl.enqueueWrite(
+            this._handle,
+            buffer,
+            bytes,
+            priority,
+            timeout
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Wait until every queued byte was handed to the system.
+     * @param {number} timeout The timeout in `ms`, a negative timeout waits forever
+     * @returns {Promise<number>} Returns the number of bytes that are still queued
+     */
+    async flushWriteQueue(
+        timeout = -1
+    ) : Promise<number> {
+        const status = await this._dl.flushWriteQueue(
+            this._handle,
+            timeout
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Get the depth and the counters of the write queue.
+     * @returns {WriteQueueStatus} Returns the status of the write queue, all zero if nothing was queued yet
+     */
+    getWriteQueueStatus() : WriteQueueStatus {
+        const buffer = new Uint8Array(writeQueueStatusSize);
+        const status = this._dl.getWriteQueueStatus(
+            this._handle,
+            buffer,
+            buffer.length
+        );
+
+        checkForErrorCode(status);
+
+        return decodeWriteQueueStatus(buffer);
+    }
+
+    /**
+     * Keep the output queue of the system at most `budget` milliseconds of the baudrate deep, writes hold the rest of their data back.
+     * A command written later then waits at most about `budget` milliseconds behind earlier data.
+     * @param {number} budget The time the queued output may take to send in `ms`, `0` turns pacing off
+     */
+    setPacing(
+        budget : number
+    ) : void {
+        const status = this._dl.setPacing(
+            this._handle,
+            budget
+        );
+
+        checkForErrorCode(status);
+    }
+
+    /**
+     * Let `readUntil` hand the line splitting to the canonical mode of the tty, which is off by default (Linux only).
+     * Once the same single byte delimiter was used a few times in a row, a read wakes up once per line instead of once per chunk.
+     * The line discipline holds at most 4095 bytes of an unfinished line and overwrites the last of them with every further byte,
+     * so do not enable it for binary data or lines that may be longer.
+     * @param {boolean} enabled Allows canonical mode, `false` switches back to raw mode right away
+     */
+    setCanonicalLines(
+        enabled : boolean
+    ) : void {
+        const status = this._dl.setCanonicalLines(
+            this._handle,
+            enabled ? 1 : 0
+        );
+
+        checkForErrorCode(status);
+    }
+
+    /**
+     * Get the number of bytes the system still has to send, without the ones in the write queue.
+     * @returns {number} Returns the number of bytes in the output queue
+     */
+    getOutputBacklog() : number {
+        const status = this._dl.getOutputBacklog(
+            this._handle
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Wait until every byte was sent, including the ones in the write queue.
+     * @param {number} timeout The timeout in `ms`, a negative timeout waits until everything is sent and `0` only checks once
+     * @returns {Promise<number>} Returns the number of bytes that were not sent in time
+     */
+    async drain(
+        timeout = -1
+    ) : Promise<number> {
+        const status = await this._dl.drain(
+            this._handle,
+            timeout
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Read data from serial connection without blocking the event loop.
+     * @param {Uint8Array} buffer Buffer to read the bytes into, it must not be touched until the promise settled
+     * @param {number} bytes The number of bytes to read
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @returns {Promise<number>} Resolves to the number of bytes read
+     */
+    async readAsync(
+        buffer : Uint8Array,
+        bytes : number,
+        timeout = 0,
+        multiplier = 10
+    ) : Promise<number> {
+        const status = await CompletionDispatcher.of(this._dl).submit((requestId) => this._dl.submitRead(
+            this._handle,
+            requestId,
+            buffer,
+            bytes,
+            timeout,
+            multiplier
+        ));
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Read data from serial connection until the search string gets send, without blocking the event loop.
+     * @param {Uint8Array} buffer Buffer to read the bytes into, it must not be touched until the promise settled
+     * @param {number} bytes The number of bytes to read
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @param {string} searchString A string to search for
+     * @returns {Promise<number>} Resolves to the number of bytes read
+     */
+    async readUntilAsync(
+        buffer : Uint8Array,
+        bytes : number,
+        timeout = 0,
+        multiplier = 10,
+        searchString = '',
+    ) : Promise<number> {
+        const status = await CompletionDispatcher.of(this._dl).submit((requestId) => this._dl.submitReadUntil(
+            this._handle,
+            requestId,
+            buffer,
+            bytes,
+            timeout,
+            multiplier,
+            searchString
+        ));
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Write data to serial connection without blocking the event loop.
+     * @param {Uint8Array} buffer The data to write/send, it must not be touched until the promise settled
+     * @param {number} bytes The number of bytes to read
+     * @param {number} timeout The timeout in `ms`
+     * @param {number} multiplier The timeout between reading individual bytes in `ms`
+     * @returns {Promise<number>} Resolves to the number of bytes written
+     */
+    async writeAsync(
+        buffer : Uint8Array,
+        bytes : number,
+        timeout = 0,
+        multiplier = 10
+    ) : Promise<number> {
+        const status = await CompletionDispatcher.of(this._dl).submit((requestId) => this._dl.submitWrite(
+            this._handle,
+            requestId,
+            buffer,
+            bytes,
+            timeout,
+            multiplier
+        ));
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Lower the latency timer of a USB serial adapter and set ASYNC_LOW_LATENCY on its driver (Linux only).
+     * Settings the device does not have or that can not be written are skipped.
+     * @param {number} latencyTimer The latency timer in `ms`, `0` only reads the current one
+     * @param {boolean} lowLatency Set ASYNC_LOW_LATENCY
+     * @param {string} sysfsRoot The root of sysfs, `/sys` if empty
+     * @returns {LatencyTuning} Returns what the device ended up with
+     */
+    tuneLatency(
+        latencyTimer = 1,
+        lowLatency = true,
+        sysfsRoot = ''
+    ) : LatencyTuning {
+        const result = new Int32Array(3);
+        const status = this._dl.tuneLatency(
+            this._handle,
+            latencyTimer,
+            lowLatency,
+            sysfsRoot,
+            new Uint8Array(result.buffer)
+        );
+
+        checkForErrorCode(status);
+
+        return {
+            previousLatencyTimer: result[0],
+            latencyTimer: result[1],
+            lowLatency: result[2]
+        };
+    }
+
+    /**
+     * Get the baudrate the driver actually runs the connection at, custom rates may be approximated.
+     * @returns {number} Returns the baudrate
+     */
+    getBaudrate() : number {
+        const status = this._dl.getBaudrate(
+            this._handle
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Get the latency histograms and counters of the calls on this connection.
+     * @returns {PortStatistics} Returns the statistics since the connection was opened
+     */
+    getStats() : PortStatistics {
+        const buffer = new Uint8Array(statisticsSize);
+        const status = this._dl.getStats(
+            this._handle,
+            buffer,
+            buffer.length
+        );
+
+        checkForErrorCode(status);
+
+        return decodeStatistics(buffer);
+    }
+
+    /**
+     * Map the receive ring of a port opened with the buffered engine, so received bytes can be read without calling into the library.
+     * Afterwards `read` and `readUntil` of this connection fail, the ring is only valid until the connection is closed.
+     * @returns {ReceiveRing} Returns the view of the receive ring
+     */
+    mapReceiveRing() : ReceiveRing {
+        const descriptor = new Uint8Array(24);
+        const status = this._dl.mapReceiveRing(
+            this._handle,
+            descriptor,
+            descriptor.length
+        )
+
+        checkForErrorCode(status);
+
+        return new ReceiveRing(descriptor);
+    }
+
     /**
      * Gat a list of the available ports.
+     * On Linux only USB ports are listed, like `/dev/serial/by-id` does, `enumeratePorts` lists every port.
      * @returns {Ports[]} Returns a list of available ports
      */
     getAvailablePorts() : Ports[] {
@@ -160,7 +648,7 @@ export class Serial {
             buffer.length,
             ','
         )
-        
+
         checkForErrorCode(status);
 
         const ports = decode(buffer).replaceAll('\x00','').split(',').map((port) => {
@@ -171,5 +659,66 @@ export class Serial {
 
         return ports;
     }
+
+    /**
+     * Get every serial port of the system together with its USB descriptors and driver.
+     * @param {string} sysfsRoot The root of sysfs, `/sys` if it is empty
+     * @returns {PortInfo[]} Returns the ports sorted by path
+     */
+    enumeratePorts(
+        sysfsRoot = ''
+    ) : PortInfo[] {
+        let capacity = 16;
+
+        // The number of ports is only known afterwards, retry with room for all of them if they did not fit
+        while (true) {
+            const buffer = new Uint8Array(capacity * portInfoSize);
+            const status = this._dl.enumeratePorts(
+                buffer,
+                buffer.length,
+                sysfsRoot
+            );
+
+            checkForErrorCode(status);
+
+            if (status <= capacity) {
+                return decodePortInfo(buffer, status);
+            }
+
+            capacity = status;
+        }
+    }
+
+    /**
+     * Get the generation of the port list, it changes whenever a port appears or disappears.
+     * @returns {number} Returns the generation, only meant to be compared for equality
+     */
+    portsGeneration() : number {
+        const status = this._dl.portsGeneration();
+
+        checkForErrorCode(status);
+
+        return status;
+    }
+
+    /**
+     * Wait until a port appears or disappears, resolves immediately if the list already changed since `generation`.
+     * @param {number} generation The generation the caller last saw
+     * @param {number} timeout The timeout in `ms`, a negative timeout waits forever
+     * @returns {Promise<number>} Returns the current generation, which equals `generation` if the timeout expired
+     */
+    async waitForPortsChange(
+        generation : number,
+        timeout = -1
+    ) : Promise<number> {
+        const status = await this._dl.waitPortsChanged(
+            generation,
+            timeout
+        );
+
+        checkForErrorCode(status);
+
+        return status;
+    }
 }
 
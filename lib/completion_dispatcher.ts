@@ -0,0 +1,95 @@
+import { SerialFunctions } from "./interfaces/serial_functions.d.ts";
+
+// Size of one completion record (request id, result)
+const completionSize = 8;
+const maxCompletions = 64;
+// Time one wait for completions may block its worker thread in `ms`
+const waitTimeout = 100;
+
+const dispatchers = new WeakMap<SerialFunctions, CompletionDispatcher>();
+
+/**
+ * Resolves the promises of submitted requests as their completions arrive.
+ * Every loaded library has one dispatcher that is shared by all connections.
+ */
+export class CompletionDispatcher {
+    private _dl : SerialFunctions;
+    private _nextRequestId : number;
+    private _pending : Map<number, (result : number) => void>;
+    private _polling : boolean;
+    private _completions : Uint8Array;
+
+    /**
+     * Get the dispatcher of the loaded library.
+     * @param {SerialFunctions} dl The loaded library
+     * @returns {CompletionDispatcher} Returns the dispatcher
+     */
+    static of(dl : SerialFunctions) : CompletionDispatcher {
+        let dispatcher = dispatchers.get(dl);
+
+        if (!dispatcher) {
+            dispatcher = new CompletionDispatcher(dl);
+            dispatchers.set(dl, dispatcher);
+        }
+
+        return dispatcher;
+    }
+
+    private constructor(dl : SerialFunctions) {
+        this._dl = dl;
+        this._nextRequestId = 0;
+        this._pending = new Map();
+        this._polling = false;
+        this._completions = new Uint8Array(maxCompletions * completionSize);
+    }
+
+    /**
+     * Submit a request and wait for its completion.
+     * @param {(requestId : number) => number} submit Submits the request with the given id and returns the status code
+     * @returns {Promise<number>} Resolves to the result of the request, which may be a status code
+     */
+    submit(submit : (requestId : number) => number) : Promise<number> {
+        const requestId = this._nextRequestId;
+        this._nextRequestId = (this._nextRequestId + 1) >>> 0;
+
+        return new Promise((resolve) => {
+            const status = submit(requestId);
+
+            if (status < 0) {
+                resolve(status);
+                return;
+            }
+
+            this._pending.set(requestId, resolve);
+            this._poll();
+        });
+    }
+
+    private async _poll() {
+        if (this._polling) {
+            return;
+        }
+
+        this._polling = true;
+
+        while (this._pending.size > 0) {
+            const count = await this._dl.waitCompletions(
+                this._completions,
+                maxCompletions,
+                waitTimeout
+            );
+
+            const view = new DataView(this._completions.buffer);
+
+            for (let i = 0; i < count; i++) {
+                const requestId = view.getUint32(i * completionSize, true);
+                const result = view.getInt32(i * completionSize + 4, true);
+
+                this._pending.get(requestId)?.(result);
+                this._pending.delete(requestId);
+            }
+        }
+
+        this._polling = false;
+    }
+}
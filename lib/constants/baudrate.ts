@@ -8,7 +8,16 @@ interface Baudrate {
     B74880: 74880,
     B115200: 115200,
     B230400: 230400,
-    B250000: 250000
+    B250000: 250000,
+    B460800: 460800,
+    B500000: 500000,
+    B921600: 921600,
+    B1000000: 1000000,
+    B1500000: 1500000,
+    B2000000: 2000000,
+    B3000000: 3000000,
+    B4000000: 4000000,
+    B12000000: 12000000
 }
 
 export const baudrate : Baudrate = {
@@ -21,5 +30,14 @@ export const baudrate : Baudrate = {
     B74880: 74880,
     B115200: 115200,
     B230400: 230400,
-    B250000: 250000
+    B250000: 250000,
+    B460800: 460800,
+    B500000: 500000,
+    B921600: 921600,
+    B1000000: 1000000,
+    B1500000: 1500000,
+    B2000000: 2000000,
+    B3000000: 3000000,
+    B4000000: 4000000,
+    B12000000: 12000000
 }
@@ -0,0 +1,13 @@
+interface Engines {
+    BLOCKING: 0,
+    REACTOR: 1,
+    IO_URING: 2,
+    BUFFERED: 3
+}
+
+export const engines : Engines = {
+    BLOCKING: 0,
+    REACTOR: 1,
+    IO_URING: 2,
+    BUFFERED: 3
+}
@@ -0,0 +1,9 @@
+interface Priorities {
+    BULK: 0,
+    URGENT: 1
+}
+
+export const priorities : Priorities = {
+    BULK: 0,
+    URGENT: 1
+}
@@ -8,7 +8,11 @@ interface StatusCodes {
     SET_PROPERTY_ERROR: -6,
     SET_TIMEOUT_ERROR: -7,
     BUFFER_ERROR: -8,
-    NOT_FOUND_ERROR: -9
+    NOT_FOUND_ERROR: -9,
+    PORT_LIMIT_ERROR: -10,
+    NOT_SUPPORTED_ERROR: -11,
+    BUSY_ERROR: -12,
+    CANCELLED_ERROR: -13
 }
 
 export const statusCodes : StatusCodes = {
@@ -21,5 +25,9 @@ export const statusCodes : StatusCodes = {
     SET_PROPERTY_ERROR: -6,
     SET_TIMEOUT_ERROR: -7,
     BUFFER_ERROR: -8,
-    NOT_FOUND_ERROR: -9
+    NOT_FOUND_ERROR: -9,
+    PORT_LIMIT_ERROR: -10,
+    NOT_SUPPORTED_ERROR: -11,
+    BUSY_ERROR: -12,
+    CANCELLED_ERROR: -13
 }
@@ -0,0 +1,7 @@
+export interface LatencyTuning {
+    // Latency timers in `ms`, `-1` if the device has none
+    previousLatencyTimer : number,
+    latencyTimer : number,
+    // `1` if ASYNC_LOW_LATENCY is set, `0` if the driver refused it, `-1` if the device does not support it
+    lowLatency : number
+}
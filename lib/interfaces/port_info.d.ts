@@ -0,0 +1,12 @@
+export interface PortInfo {
+    // Device path, e.g. `/dev/ttyUSB0` or `COM3`
+    path : string,
+    // USB descriptors, `0`/empty if the port is no USB device
+    vendorId : number,
+    productId : number,
+    serialNumber : string,
+    // Kernel driver of the port, empty on Windows
+    driver : string,
+    // USB interface of the port, `-1` if the port is no USB device
+    interfaceNumber : number
+}
@@ -0,0 +1,16 @@
+export interface PortStatistics {
+    reads : number,
+    writes : number,
+    bytesRead : number,
+    bytesWritten : number,
+    timeouts : number,
+    shortReads : number,
+    shortWrites : number,
+    readErrors : number,
+    writeErrors : number,
+    // Counts per bucket, see `bucketLowerBound`
+    readLatencyNs : number[],
+    writeLatencyNs : number[],
+    readBytes : number[],
+    writeBytes : number[]
+}
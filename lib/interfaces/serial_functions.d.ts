@@ -6,31 +6,174 @@ export interface SerialFunctions {
         baudrate : number,
         dataBits : number,
         parity : parity,
-        stopBits : number
+        stopBits : number,
+        engine : number,
+        receiveBufferSize : number
+    ) => number,
+    close: (
+        handle : number
+    ) => number,
+    cancel: (
+        handle : number
     ) => number,
-    close: () => number,
     read: (
+        handle : number,
         buffer : Uint8Array,
         bufferSize : number,
         timeout : number,
         multiplier : number
     ) => number,
     readUntil: (
+        handle : number,
         buffer : Uint8Array,
         bufferSize : number,
         timeout : number,
         multiplier : number,
         searchString : string
     ) => number,
+    readLines: (
+        handle : number,
+        buffer : Uint8Array,
+        bufferSize : number,
+        offsets : Uint32Array,
+        maxLines : number,
+        timeout : number,
+        multiplier : number,
+        searchString : string
+    ) => number,
     write: (
+        handle : number,
+        buffer : Uint8Array,
+        bufferSize : number,
+        timeout : number,
+        multiplier : number
+    ) => number,
+    readv: (
+        handle : number,
+        segments : BigUint64Array,
+        segmentCount : number,
+        timeout : number,
+        multiplier : number
+    ) => number,
+    writev: (
+        handle : number,
+        segments : BigUint64Array,
+        segmentCount : number,
+        timeout : number,
+        multiplier : number
+    ) => number,
+    transact: (
+        handle : number,
+        request : Uint8Array,
+        requestSize : number,
+        response : Uint8Array,
+        responseSize : number,
+        timeout : number,
+        multiplier : number,
+        searchString : string,
+        result : Uint8Array
+    ) => number,
+    configureWriteQueue: (
+        handle : number,
+        capacity : number,
+        coalesceBytes : number,
+        coalesceDelay : number,
+        sliceSize : number
+    ) => number,
+    enqueueWrite: (
+        handle : number,
+        buffer : Uint8Array,
+        bytes : number,
+        priority : number,
+        timeout : number
+    ) => number,
+    flushWriteQueue: (
+        handle : number,
+        timeout : number
+    ) => Promise<number>,
+    getWriteQueueStatus: (
+        handle : number,
+        buffer : Uint8Array,
+        bufferSize : number
+    ) => number,
+    setPacing: (
+        handle : number,
+        budget : number
+    ) => number,
+    setCanonicalLines: (
+        handle : number,
+        enabled : number
+    ) => number,
+    getOutputBacklog: (
+        handle : number
+    ) => number,
+    drain: (
+        handle : number,
+        timeout : number
+    ) => Promise<number>,
+    submitRead: (
+        handle : number,
+        requestId : number,
         buffer : Uint8Array,
         bufferSize : number,
         timeout : number,
         multiplier : number
     ) => number,
+    submitReadUntil: (
+        handle : number,
+        requestId : number,
+        buffer : Uint8Array,
+        bufferSize : number,
+        timeout : number,
+        multiplier : number,
+        searchString : string
+    ) => number,
+    submitWrite: (
+        handle : number,
+        requestId : number,
+        buffer : Uint8Array,
+        bufferSize : number,
+        timeout : number,
+        multiplier : number
+    ) => number,
+    waitCompletions: (
+        completions : Uint8Array,
+        maxCompletions : number,
+        timeout : number
+    ) => Promise<number>,
+    tuneLatency: (
+        handle : number,
+        latencyTimer : number,
+        lowLatency : boolean,
+        sysfsRoot : string,
+        result : Uint8Array
+    ) => number,
+    getBaudrate: (
+        handle : number
+    ) => number,
+    getStats: (
+        handle : number,
+        buffer : Uint8Array,
+        bufferSize : number
+    ) => number,
+    mapReceiveRing: (
+        handle : number,
+        descriptor : Uint8Array,
+        descriptorSize : number
+    ) => number,
     getAvailablePorts: (
         buffer : Uint8Array,
         bufferSize : number,
         separator : string
-    ) => number
+    ) => number,
+    enumeratePorts: (
+        buffer : Uint8Array,
+        bufferSize : number,
+        sysfsRoot : string
+    ) => number,
+    portsGeneration: () => number,
+    waitPortsChanged: (
+        generation : number,
+        timeout : number
+    ) => Promise<number>
 }
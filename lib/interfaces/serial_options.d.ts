@@ -5,5 +5,9 @@ import { stopBits } from "../constants/stop_bits.ts";
 export interface SerialOptions {
     dataBits? : dataBits,
     parity? : parity,
-    stopBits? : stopBits
+    stopBits? : stopBits,
+    engine? : number,
+    receiveBufferSize? : number,
+    // Lowers the latency timer of USB serial adapters to this many `ms` and sets ASYNC_LOW_LATENCY (Linux only)
+    latencyTimer? : number
 }
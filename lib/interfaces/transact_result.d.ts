@@ -0,0 +1,4 @@
+export interface TransactResult {
+    bytesWritten : number,
+    bytesRead : number
+}
@@ -0,0 +1,15 @@
+export interface WriteQueueStatus {
+    capacity : number,
+    // Bytes that are queued or being written
+    depth : number,
+    highWater : number,
+    bytesQueued : number,
+    bytesWritten : number,
+    writes : number,
+    // Enqueues that found no room in time
+    rejected : number,
+    errors : number,
+    urgentBytes : number,
+    // Longest time from queueing an urgent byte until it was written
+    maxUrgentLatencyNs : number
+}
@@ -1,7 +1,15 @@
 import { SerialFunctions } from "./interfaces/serial_functions.d.ts";
 import { registerSerialFunctions } from "./register_serial_functions.ts";
 
+// Every `Serial` instance shares the same loaded library, the ports are told apart by their handles
+const loadedDLs = new Map<string, SerialFunctions>();
+
 export function loadDL(path : string, os : string) : SerialFunctions {
+    const loadedDL = loadedDLs.get(`${path}/${os}`);
+    if (loadedDL) {
+        return loadedDL;
+    }
+
     let libSuffix = '';
 
     switch(os) {
@@ -10,7 +18,11 @@ export function loadDL(path : string, os : string) : SerialFunctions {
             break;
         }
 
-        case 'linux':
+        case 'linux': {
+            libSuffix = 'so';
+            break;
+        }
+
         case 'darwin':
         case 'freebsd':
         case 'netbsd':
@@ -23,7 +35,7 @@ export function loadDL(path : string, os : string) : SerialFunctions {
                 Current stage:
 
                 - Windows (implemented)
-                - Linux (in progress)
+                - Linux (implemented)
                 - MacOS (planned)
                 
                 For more information feel free to check out the repository:
@@ -36,5 +48,23 @@ export function loadDL(path : string, os : string) : SerialFunctions {
         }
     }
     
-    return registerSerialFunctions(path, os, libSuffix);
+    const library = `${path}/${os}.${libSuffix}`;
+
+    // The library is built from `src` by CMake, whose `dls` target copies it here
+    try {
+        Deno.statSync(library);
+    } catch {
+        throw new Error(
+            `The native library ${library} is missing.
+            Build it with CMake first, the \`dls\` target copies it into ${path}:
+
+            cmake -S . -B build
+            cmake --build build --config Release --target dls`
+        );
+    }
+
+    const dl = registerSerialFunctions(path, os, libSuffix);
+    loadedDLs.set(`${path}/${os}`, dl);
+
+    return dl;
 }
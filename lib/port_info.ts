@@ -0,0 +1,31 @@
+import { decode } from "./decode.ts";
+import { PortInfo } from "./interfaces/port_info.d.ts";
+
+// Size of one `PortInfo` record `serialEnumeratePorts` writes
+export const portInfoSize = 232;
+
+// Decodes a NUL terminated string field of a record
+const field = (buffer : Uint8Array, offset : number, size : number) : string => {
+    const bytes = buffer.subarray(offset, offset + size);
+    const end = bytes.indexOf(0);
+
+    return decode(end < 0 ? bytes : bytes.subarray(0, end));
+};
+
+// Decodes the records `serialEnumeratePorts` wrote
+export const decodePortInfo = (buffer : Uint8Array, count : number) : PortInfo[] => {
+    const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+
+    return Array.from({ length: count }, (_, i) => {
+        const offset = i * portInfoSize;
+
+        return {
+            path: field(buffer, offset, 128),
+            serialNumber: field(buffer, offset + 128, 64),
+            driver: field(buffer, offset + 192, 32),
+            vendorId: view.getUint16(offset + 224, true),
+            productId: view.getUint16(offset + 226, true),
+            interfaceNumber: view.getInt32(offset + 228, true)
+        };
+    });
+};
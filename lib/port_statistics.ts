@@ -0,0 +1,39 @@
+import { PortStatistics } from "./interfaces/port_statistics.d.ts";
+
+// Size of the `PortStatistics` header that precedes the histograms
+const headerSize = 80;
+const bucketCount = 496;
+const histogramCount = 4;
+
+// Size of the buffer `serialGetStats` needs
+export const statisticsSize = headerSize + histogramCount * bucketCount * 8;
+
+// Smallest value that is counted in the histogram bucket
+export const bucketLowerBound = (bucket : number) : number =>
+    bucket < 16 ? bucket : (8 + bucket % 8) * 2 ** (Math.floor(bucket / 8) - 1);
+
+// Decodes the statistics `serialGetStats` wrote
+export const decodeStatistics = (buffer : Uint8Array) : PortStatistics => {
+    const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+    const counter = (index : number) => Number(view.getBigUint64(8 + index * 8, true));
+    const histogram = (index : number) => Array.from(
+        { length: bucketCount },
+        (_, bucket) => Number(view.getBigUint64(headerSize + (index * bucketCount + bucket) * 8, true))
+    );
+
+    return {
+        reads: counter(0),
+        writes: counter(1),
+        bytesRead: counter(2),
+        bytesWritten: counter(3),
+        timeouts: counter(4),
+        shortReads: counter(5),
+        shortWrites: counter(6),
+        readErrors: counter(7),
+        writeErrors: counter(8),
+        readLatencyNs: histogram(0),
+        writeLatencyNs: histogram(1),
+        readBytes: histogram(2),
+        writeBytes: histogram(3)
+    };
+};
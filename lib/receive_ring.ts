@@ -0,0 +1,65 @@
+/**
+ * View of the native receive ring of a buffered port.
+ * The native reader thread publishes the received bytes into the ring and this
+ * view consumes them straight from memory, without any call into the library.
+ */
+export class ReceiveRing {
+    private _control : Uint32Array;
+    private _data : Uint8Array;
+    private _capacity : number;
+    private _headIndex : number;
+    private _tailIndex : number;
+
+    /**
+     * Map the ring described by the descriptor `serialMapReceiveRing` wrote.
+     * @param {Uint8Array} descriptor The `ReceiveRingDescriptor` (address, capacity, head/tail/data offsets)
+     */
+    constructor(descriptor : Uint8Array) {
+        const view = new DataView(descriptor.buffer, descriptor.byteOffset, descriptor.byteLength);
+        const address = view.getBigUint64(0, true);
+        const headOffset = view.getUint32(12, true);
+        const tailOffset = view.getUint32(16, true);
+        const dataOffset = view.getUint32(20, true);
+
+        this._capacity = view.getUint32(8, true);
+
+        const memory = Deno.UnsafePointerView.getArrayBuffer(
+            Deno.UnsafePointer.create(address)!,
+            dataOffset + this._capacity
+        );
+
+        this._control = new Uint32Array(memory, 0, dataOffset / Uint32Array.BYTES_PER_ELEMENT);
+        this._data = new Uint8Array(memory, dataOffset, this._capacity);
+        this._headIndex = headOffset / Uint32Array.BYTES_PER_ELEMENT;
+        this._tailIndex = tailOffset / Uint32Array.BYTES_PER_ELEMENT;
+    }
+
+    /**
+     * Get the number of bytes that are ready to be read.
+     * @returns {number} Returns the number of bytes in the ring
+     */
+    get available() : number {
+        return (Atomics.load(this._control, this._tailIndex) - Atomics.load(this._control, this._headIndex)) >>> 0;
+    }
+
+    /**
+     * Read the received bytes out of the ring.
+     * @param {Uint8Array} buffer Buffer to read the bytes into
+     * @returns {number} Returns number of bytes read
+     */
+    read(buffer : Uint8Array) : number {
+        const head = Atomics.load(this._control, this._headIndex);
+        const tail = Atomics.load(this._control, this._tailIndex);
+        const count = Math.min(buffer.length, (tail - head) >>> 0);
+        const offset = head & (this._capacity - 1);
+        const first = Math.min(count, this._capacity - offset);
+
+        buffer.set(this._data.subarray(offset, offset + first));
+        buffer.set(this._data.subarray(0, count - first), first);
+
+        // Hands the room back to the native reader thread
+        Atomics.store(this._control, this._headIndex, (head + count) >>> 0);
+
+        return count;
+    }
+}
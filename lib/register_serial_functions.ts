@@ -8,7 +8,7 @@ export function registerSerialFunctions(
     libSuffix : string
 ) : SerialFunctions {
     const serialFunctions = Deno.dlopen(`${path}/${os}.${libSuffix}`, {
-        'open': {
+        'serialOpen': {
             parameters: [
                 // Port
                 'buffer',
@@ -19,18 +19,35 @@ export function registerSerialFunctions(
                 // Parity
                 'i32',
                 // Stop Bits
+                'i32',
+                // Engine
+                'i32',
+                // Receive Buffer Size
+                'i32'
+            ],
+            // Status code/Handle
+            result: 'i32'
+        },
+        'serialClose': {
+            parameters: [
+                // Handle
                 'i32'
             ],
             // Status code
             result: 'i32'
         },
-        'close': {
-            parameters: [],
+        'serialCancel': {
+            parameters: [
+                // Handle
+                'i32'
+            ],
             // Status code
             result: 'i32'
         },
-        'read': {
+        'serialRead': {
             parameters: [
+                // Handle
+                'i32',
                 // Buffer
                 'buffer',
                 // Buffer Size
@@ -43,8 +60,10 @@ export function registerSerialFunctions(
             // Status code/Bytes read
             result: 'i32'
         },
-        'readUntil': {
+        'serialReadUntil': {
             parameters: [
+                // Handle
+                'i32',
                 // Buffer
                 'buffer',
                 // Buffer Size
@@ -59,8 +78,242 @@ export function registerSerialFunctions(
             // Status code/Bytes read
             result: 'i32'
         },
-        'write': {
+        'serialReadLines': {
+            parameters: [
+                // Handle
+                'i32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Offsets
+                'buffer',
+                // Max Lines
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32',
+                // SearchString
+                'buffer'
+            ],
+            // Status code/Lines read
+            result: 'i32'
+        },
+        'serialWrite': {
+            parameters: [
+                // Handle
+                'i32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32'
+            ],
+            // Status code/Bytes written
+            result: 'i32'
+        },
+        'serialReadv': {
+            parameters: [
+                // Handle
+                'i32',
+                // Segments
+                'buffer',
+                // Segment Count
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32'
+            ],
+            // Status code/Bytes read
+            result: 'i32'
+        },
+        'serialWritev': {
+            parameters: [
+                // Handle
+                'i32',
+                // Segments
+                'buffer',
+                // Segment Count
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32'
+            ],
+            // Status code/Bytes written
+            result: 'i32'
+        },
+        'serialTransact': {
+            parameters: [
+                // Handle
+                'i32',
+                // Request
+                'buffer',
+                // Request Size
+                'i32',
+                // Response
+                'buffer',
+                // Response Size
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32',
+                // SearchString
+                'buffer',
+                // Result
+                'buffer',
+                // Result Size
+                'i32'
+            ],
+            // Status code/Bytes read
+            result: 'i32'
+        },
+        'serialConfigureWriteQueue': {
+            parameters: [
+                // Handle
+                'i32',
+                // Capacity
+                'i32',
+                // Coalesce Bytes
+                'i32',
+                // Coalesce Delay
+                'i32',
+                // Slice Size
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialEnqueueWrite': {
+            parameters: [
+                // Handle
+                'i32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Priority
+                'i32',
+                // Timeout
+                'i32'
+            ],
+            // Status code/Bytes queued
+            result: 'i32'
+        },
+        'serialFlushWriteQueue': {
+            parameters: [
+                // Handle
+                'i32',
+                // Timeout
+                'i32'
+            ],
+            // Status code/Bytes still queued
+            result: 'i32',
+            // Runs on its own thread, so waiting does not block the event loop
+            nonblocking: true
+        },
+        'serialGetWriteQueueStatus': {
+            parameters: [
+                // Handle
+                'i32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialSetPacing': {
+            parameters: [
+                // Handle
+                'i32',
+                // Budget
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialSetCanonicalLines': {
+            parameters: [
+                // Handle
+                'i32',
+                // Enabled
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialGetOutputBacklog': {
+            parameters: [
+                // Handle
+                'i32'
+            ],
+            // Status code/Bytes in the output queue
+            result: 'i32'
+        },
+        'serialDrain': {
+            parameters: [
+                // Handle
+                'i32',
+                // Timeout
+                'i32'
+            ],
+            // Status code/Bytes not sent
+            result: 'i32',
+            // Runs on its own thread, so waiting does not block the event loop
+            nonblocking: true
+        },
+        'serialSubmitRead': {
+            parameters: [
+                // Handle
+                'i32',
+                // Request Id
+                'u32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialSubmitReadUntil': {
             parameters: [
+                // Handle
+                'i32',
+                // Request Id
+                'u32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Timeout
+                'i32',
+                // Multiplier
+                'i32',
+                // SearchString
+                'buffer'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialSubmitWrite': {
+            parameters: [
+                // Handle
+                'i32',
+                // Request Id
+                'u32',
                 // Buffer
                 'buffer',
                 // Buffer Size
@@ -70,10 +323,74 @@ export function registerSerialFunctions(
                 // Multiplier
                 'i32'
             ],
+            // Status code
+            result: 'i32'
+        },
+        'serialWaitCompletions': {
+            parameters: [
+                // Completions
+                'buffer',
+                // Max Completions
+                'i32',
+                // Timeout
+                'i32'
+            ],
+            // Status code/Amount of completions
+            result: 'i32',
+            // Runs on its own thread, so waiting does not block the event loop
+            nonblocking: true
+        },
+        'serialTuneLatency': {
+            parameters: [
+                // Handle
+                'i32',
+                // Latency Timer
+                'i32',
+                // Low Latency
+                'i32',
+                // Sysfs Root
+                'buffer',
+                // Result
+                'buffer',
+                // Result Size
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialGetBaudrate': {
+            parameters: [
+                // Handle
+                'i32'
+            ],
+            // Status code/Baudrate
+            result: 'i32'
+        },
+        'serialGetStats': {
+            parameters: [
+                // Handle
+                'i32',
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32'
+            ],
             // Status code/Bytes written
             result: 'i32'
         },
-        'getAvailablePorts': {
+        'serialMapReceiveRing': {
+            parameters: [
+                // Handle
+                'i32',
+                // Descriptor
+                'buffer',
+                // Descriptor Size
+                'i32'
+            ],
+            // Status code
+            result: 'i32'
+        },
+        'serialGetAvailablePorts': {
             parameters: [
                 // Buffer
                 'buffer',
@@ -84,6 +401,35 @@ export function registerSerialFunctions(
             ],
             // Status code/Amount of ports
             result: 'i32'
+        },
+        'serialEnumeratePorts': {
+            parameters: [
+                // Buffer
+                'buffer',
+                // Buffer Size
+                'i32',
+                // Sysfs Root
+                'buffer'
+            ],
+            // Status code/Amount of ports
+            result: 'i32'
+        },
+        'serialPortsGeneration': {
+            parameters: [],
+            // Status code/Generation
+            result: 'i32'
+        },
+        'serialWaitPortsChanged': {
+            parameters: [
+                // Generation
+                'i32',
+                // Timeout
+                'i32'
+            ],
+            // Status code/Generation
+            result: 'i32',
+            // Runs on its own thread, so waiting does not block the event loop
+            nonblocking: true
         }
     }).symbols
     
@@ -93,58 +439,322 @@ export function registerSerialFunctions(
             baudrate : number,
             dataBits : number,
             parity : parity,
-            stopBits : number
-        ) : number => serialFunctions.open(
+            stopBits : number,
+            engine : number,
+            receiveBufferSize : number
+        ) : number => serialFunctions.serialOpen(
             encode(port + '\0'),
             baudrate,
             dataBits,
             parity,
-            stopBits
+            stopBits,
+            engine,
+            receiveBufferSize
+        ),
+        close: (
+            handle : number
+        ) : number => serialFunctions.serialClose(
+            handle
+        ),
+        cancel: (
+            handle : number
+        ) : number => serialFunctions.serialCancel(
+            handle
         ),
-        close: () : number => serialFunctions.close(),
         read: (
+            handle : number,
             buffer : Uint8Array,
             bytes : number,
             timeout : number,
             multiplier : number
-        ) : number => serialFunctions.read(
+        ) : number => serialFunctions.serialRead(
+            handle,
             buffer,
             bytes,
             timeout,
             multiplier
         ),
         readUntil: (
+            handle : number,
             buffer : Uint8Array,
             bytes : number,
             timeout : number,
             multiplier : number,
             searchString : string
-        ) : number => serialFunctions.readUntil(
+        ) : number => serialFunctions.serialReadUntil(
+            handle,
             buffer,
             bytes,
             timeout,
             multiplier,
             encode(searchString + '\0')
         ),
+        readLines: (
+            handle : number,
+            buffer : Uint8Array,
+            bytes : number,
+            offsets : Uint32Array,
+            maxLines : number,
+            timeout : number,
+            multiplier : number,
+            searchString : string
+        ) : number => serialFunctions.serialReadLines(
+            handle,
+            buffer,
+            bytes,
+            offsets,
+            maxLines,
+            timeout,
+            multiplier,
+            encode(searchString + '\0')
+        ),
         write: (
+            handle : number,
+            buffer : Uint8Array,
+            bytes : number,
+            timeout : number,
+            multiplier : number
+        ) : number => serialFunctions.serialWrite(
+            handle,
+            buffer,
+            bytes,
+            timeout,
+            multiplier
+        ),
+        readv: (
+            handle : number,
+            segments : BigUint64Array,
+            segmentCount : number,
+            timeout : number,
+            multiplier : number
+        ) : number => serialFunctions.serialReadv(
+            handle,
+            segments,
+            segmentCount,
+            timeout,
+            multiplier
+        ),
+        writev: (
+            handle : number,
+            segments : BigUint64Array,
+            segmentCount : number,
+            timeout : number,
+            multiplier : number
+        ) : number => serialFunctions.serialWritev(
+            handle,
+            segments,
+            segmentCount,
+            timeout,
+            multiplier
+        ),
+        transact: (
+            handle : number,
+            request : Uint8Array,
+            requestSize : number,
+            response : Uint8Array,
+            responseSize : number,
+            timeout : number,
+            multiplier : number,
+            searchString : string,
+            result : Uint8Array
+        ) : number => serialFunctions.serialTransact(
+            handle,
+            request,
+            requestSize,
+            response,
+            responseSize,
+            timeout,
+            multiplier,
+            encode(searchString + '\0'),
+            result,
+            result.byteLength
+        ),
+        configureWriteQueue: (
+            handle : number,
+            capacity : number,
+            coalesceBytes : number,
+            coalesceDelay : number,
+            sliceSize : number
+        ) : number => serialFunctions.serialConfigureWriteQueue(
+            handle,
+            capacity,
+            coalesceBytes,
+            coalesceDelay,
+            sliceSize
+        ),
+        enqueueWrite: (
+            handle : number,
+            buffer : Uint8Array,
+            bytes : number,
+            priority : number,
+            timeout : number
+        ) : number => serialFunctions.serialEnqueueWrite(
+            handle,
+            buffer,
+            bytes,
+            priority,
+            timeout
+        ),
+        flushWriteQueue: (
+            handle : number,
+            timeout : number
+        ) : Promise<number> => serialFunctions.serialFlushWriteQueue(
+            handle,
+            timeout
+        ),
+        getWriteQueueStatus: (
+            handle : number,
+            buffer : Uint8Array,
+            bufferSize : number
+        ) : number => serialFunctions.serialGetWriteQueueStatus(
+            handle,
+            buffer,
+            bufferSize
+        ),
+        setPacing: (
+            handle : number,
+            budget : number
+        ) : number => serialFunctions.serialSetPacing(
+            handle,
+            budget
+        ),
+        setCanonicalLines: (
+            handle : number,
+            enabled : number
+        ) : number => serialFunctions.serialSetCanonicalLines(
+            handle,
+            enabled
+        ),
+        getOutputBacklog: (
+            handle : number
+        ) : number => serialFunctions.serialGetOutputBacklog(
+            handle
+        ),
+        drain: (
+            handle : number,
+            timeout : number
+        ) : Promise<number> => serialFunctions.serialDrain(
+            handle,
+            timeout
+        ),
+        submitRead: (
+            handle : number,
+            requestId : number,
+            buffer : Uint8Array,
+            bytes : number,
+            timeout : number,
+            multiplier : number
+        ) : number => serialFunctions.serialSubmitRead(
+            handle,
+            requestId,
+            buffer,
+            bytes,
+            timeout,
+            multiplier
+        ),
+        submitReadUntil: (
+            handle : number,
+            requestId : number,
+            buffer : Uint8Array,
+            bytes : number,
+            timeout : number,
+            multiplier : number,
+            searchString : string
+        ) : number => serialFunctions.serialSubmitReadUntil(
+            handle,
+            requestId,
+            buffer,
+            bytes,
+            timeout,
+            multiplier,
+            encode(searchString + '\0')
+        ),
+        submitWrite: (
+            handle : number,
+            requestId : number,
             buffer : Uint8Array,
             bytes : number,
             timeout : number,
             multiplier : number
-        ) : number => serialFunctions.write(
+        ) : number => serialFunctions.serialSubmitWrite(
+            handle,
+            requestId,
             buffer,
             bytes,
             timeout,
             multiplier
         ),
+        waitCompletions: (
+            completions : Uint8Array,
+            maxCompletions : number,
+            timeout : number
+        ) : Promise<number> => serialFunctions.serialWaitCompletions(
+            completions,
+            maxCompletions,
+            timeout
+        ),
+        tuneLatency: (
+            handle : number,
+            latencyTimer : number,
+            lowLatency : boolean,
+            sysfsRoot : string,
+            result : Uint8Array
+        ) : number => serialFunctions.serialTuneLatency(
+            handle,
+            latencyTimer,
+            lowLatency ? 1 : 0,
+            encode(sysfsRoot + '\0'),
+            result,
+            result.byteLength
+        ),
+        getBaudrate: (
+            handle : number
+        ) : number => serialFunctions.serialGetBaudrate(
+            handle
+        ),
+        getStats: (
+            handle : number,
+            buffer : Uint8Array,
+            bufferSize : number
+        ) : number => serialFunctions.serialGetStats(
+            handle,
+            buffer,
+            bufferSize
+        ),
+        mapReceiveRing: (
+            handle : number,
+            descriptor : Uint8Array,
+            descriptorSize : number
+        ) : number => serialFunctions.serialMapReceiveRing(
+            handle,
+            descriptor,
+            descriptorSize
+        ),
         getAvailablePorts: (
             buffer : Uint8Array,
             bytes : number,
             separator : string
-        ) : number => serialFunctions.getAvailablePorts(
+        ) : number => serialFunctions.serialGetAvailablePorts(
             buffer,
             bytes,
             encode(separator + '\0')
+        ),
+        enumeratePorts: (
+            buffer : Uint8Array,
+            bufferSize : number,
+            sysfsRoot : string
+        ) : number => serialFunctions.serialEnumeratePorts(
+            buffer,
+            bufferSize,
+            encode(sysfsRoot + '\0')
+        ),
+        portsGeneration: () : number => serialFunctions.serialPortsGeneration(),
+        waitPortsChanged: (
+            generation : number,
+            timeout : number
+        ) : Promise<number> => serialFunctions.serialWaitPortsChanged(
+            generation,
+            timeout
         )
     }
 }
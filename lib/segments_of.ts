@@ -0,0 +1,11 @@
+// Builds the `IoSegment` array (address, length) of the buffers for readv and writev
+export const segmentsOf = (buffers : Uint8Array[]) : BigUint64Array => {
+    const segments = new BigUint64Array(buffers.length * 2);
+
+    buffers.forEach((buffer, i) => {
+        segments[i * 2] = BigInt(Deno.UnsafePointer.value(Deno.UnsafePointer.of(buffer)));
+        segments[i * 2 + 1] = BigInt(buffer.byteLength);
+    });
+
+    return segments;
+};
@@ -0,0 +1,23 @@
+import { WriteQueueStatus } from "./interfaces/write_queue_status.d.ts";
+
+// Size of the buffer `serialGetWriteQueueStatus` needs
+export const writeQueueStatusSize = 80;
+
+// Decodes the status `serialGetWriteQueueStatus` wrote
+export const decodeWriteQueueStatus = (buffer : Uint8Array) : WriteQueueStatus => {
+    const view = new DataView(buffer.buffer, buffer.byteOffset, buffer.byteLength);
+    const counter = (index : number) => Number(view.getBigUint64(index * 8, true));
+
+    return {
+        capacity: counter(0),
+        depth: counter(1),
+        highWater: counter(2),
+        bytesQueued: counter(3),
+        bytesWritten: counter(4),
+        writes: counter(5),
+        rejected: counter(6),
+        errors: counter(7),
+        urgentBytes: counter(8),
+        maxUrgentLatencyNs: counter(9)
+    };
+};
@@ -1,6 +1,15 @@
 export { Serial } from './lib/Serial.ts';
+export { ReceiveRing } from './lib/receive_ring.ts';
 export { baudrate } from './lib/constants/baudrate.ts';
 export { dataBits } from './lib/constants/data_bits.ts';
 export { parity } from './lib/constants/parity.ts';
 export { stopBits } from './lib/constants/stop_bits.ts';
 export { statusCodes } from './lib/constants/status_codes.ts';
+export { engines } from './lib/constants/engines.ts';
+export { priorities } from './lib/constants/priorities.ts';
+export { bucketLowerBound } from './lib/port_statistics.ts';
+export type { PortInfo } from './lib/interfaces/port_info.d.ts';
+export type { LatencyTuning } from './lib/interfaces/latency_tuning.d.ts';
+export type { PortStatistics } from './lib/interfaces/port_statistics.d.ts';
+export type { TransactResult } from './lib/interfaces/transact_result.d.ts';
+export type { WriteQueueStatus } from './lib/interfaces/write_queue_status.d.ts';
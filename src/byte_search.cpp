@@ -0,0 +1,96 @@
+#include "byte_search.h"
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+// 32 bit x86 only has SSE2 if the compiler targets it, otherwise the search stays scalar
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define BYTE_SEARCH_SSE2
+    #include <immintrin.h>
+    #if defined(__GNUC__)
+        // AVX2 is compiled for this function only and picked at runtime
+        #define BYTE_SEARCH_AVX2
+    #endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #define BYTE_SEARCH_NEON
+    #include <arm_neon.h>
+#endif
+
+static auto findByteScalar(const char* data, std::size_t size, char byte) -> std::size_t {
+    const void *found = memchr(data, byte, size);
+    return found ? static_cast<std::size_t>(static_cast<const char*>(found) - data) : size;
+}
+
+#if defined(BYTE_SEARCH_SSE2)
+static auto findByteSse2(const char* data, std::size_t size, char byte) -> std::size_t {
+    const __m128i needle = _mm_set1_epi8(byte);
+    std::size_t i{0};
+
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        const unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, needle)));
+
+        if (mask != 0) {
+            return i + std::countr_zero(mask);
+        }
+    }
+
+    return i + findByteScalar(data + i, size - i, byte);
+}
+#endif
+
+#if defined(BYTE_SEARCH_AVX2)
+__attribute__((target("avx2")))
+static auto findByteAvx2(const char* data, std::size_t size, char byte) -> std::size_t {
+    const __m256i needle = _mm256_set1_epi8(byte);
+    std::size_t i{0};
+
+    for (; i + 32 <= size; i += 32) {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, needle)));
+
+        if (mask != 0) {
+            return i + std::countr_zero(mask);
+        }
+    }
+
+    return i + findByteSse2(data + i, size - i, byte);
+}
+#endif
+
+#if defined(BYTE_SEARCH_NEON)
+static auto findByteNeon(const char* data, std::size_t size, char byte) -> std::size_t {
+    const uint8x16_t needle = vdupq_n_u8(static_cast<std::uint8_t>(byte));
+    std::size_t i{0};
+
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t matches = vceqq_u8(vld1q_u8(reinterpret_cast<const std::uint8_t*>(data + i)), needle);
+
+        // Narrowing by four bits per byte turns the compare result into a 64 bit mask
+        const std::uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(matches), 4)), 0);
+
+        if (mask != 0) {
+            return i + (std::countr_zero(mask) >> 2);
+        }
+    }
+
+    return i + findByteScalar(data + i, size - i, byte);
+}
+#endif
+
+auto findByte(const char* data, std::size_t size, char byte) -> std::size_t {
+#if defined(BYTE_SEARCH_AVX2)
+    static const bool hasAvx2 = __builtin_cpu_supports("avx2");
+    if (hasAvx2) {
+        return findByteAvx2(data, size, byte);
+    }
+#endif
+#if defined(BYTE_SEARCH_SSE2)
+    return findByteSse2(data, size, byte);
+#elif defined(BYTE_SEARCH_NEON)
+    return findByteNeon(data, size, byte);
+#else
+    return findByteScalar(data, size, byte);
+#endif
+}
@@ -0,0 +1,102 @@
+#include "completion_queue.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+// Time an idle worker waits for the next operation of its port before it exits
+constexpr std::chrono::seconds workerIdleTimeout{1};
+
+// Operations that may be queued, running or waiting to be picked up before submissions are refused
+constexpr std::size_t maxOutstanding = 4096;
+
+auto CompletionQueue::instance() -> CompletionQueue& {
+    // Never destroyed, detached workers may still reference it while the process exits
+    static CompletionQueue *queue = new CompletionQueue();
+    return *queue;
+}
+
+auto CompletionQueue::submit(int handle, Lane lane, std::uint32_t requestId, Operation operation) -> bool {
+    {
+        std::lock_guard completionLock(completionMutex);
+
+        if (outstanding >= maxOutstanding) {
+            return false;
+        }
+
+        outstanding++;
+    }
+
+    std::lock_guard lock(workerMutex);
+
+    const WorkerKey key{handle, lane};
+    Worker &worker = workers[key];
+    worker.requests.push_back(Request{requestId, std::move(operation)});
+
+    if (worker.running) {
+        worker.ready.notify_one();
+        return true;
+    }
+
+    worker.running = true;
+    std::thread([this, key] { work(key); }).detach();
+
+    return true;
+}
+
+auto CompletionQueue::work(const WorkerKey key) -> void {
+    std::unique_lock lock(workerMutex);
+
+    while (true) {
+        Worker &worker = workers[key];
+
+        if (worker.requests.empty()) {
+            const bool woken = worker.ready.wait_for(lock, workerIdleTimeout, [&] {
+                return !worker.requests.empty();
+            });
+
+            if (!woken) {
+                workers.erase(key);
+                return;
+            }
+
+            continue;
+        }
+
+        Request request = std::move(worker.requests.front());
+        worker.requests.pop_front();
+
+        lock.unlock();
+        const int result = request.operation();
+
+        {
+            std::lock_guard completionLock(completionMutex);
+            completions.push_back(Completion{request.requestId, result});
+        }
+        completionReady.notify_all();
+
+        lock.lock();
+    }
+}
+
+auto CompletionQueue::wait(Completion* out, int maxCompletions, int timeout) -> int {
+    std::unique_lock lock(completionMutex);
+
+    auto hasCompletions = [this] {
+        return !completions.empty();
+    };
+
+    if (timeout < 0) {
+        completionReady.wait(lock, hasCompletions);
+    } else {
+        completionReady.wait_for(lock, std::chrono::milliseconds(timeout), hasCompletions);
+    }
+
+    const std::size_t count = std::min(completions.size(), static_cast<std::size_t>(std::max(maxCompletions, 0)));
+
+    memcpy(out, completions.data(), count * sizeof(Completion));
+    completions.erase(completions.begin(), completions.begin() + count);
+    outstanding -= count;
+
+    return static_cast<int>(count);
+}
@@ -0,0 +1,248 @@
+#if defined(__linux__)
+#include "event_loop.h"
+#include "status_codes.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace serial {
+
+    // Events taken from the epoll instance per turn
+    constexpr int maxEvents = 256;
+
+    EventLoop::Wait::Wait(EventLoop &loop, Channel &channel, const std::uint32_t events, const int timeout) :
+        loop(loop),
+        timeout(timeout) {
+        waiter.channel = &channel;
+        waiter.events = events;
+    }
+
+    EventLoop::Wait::~Wait() {
+        Channel &channel = *waiter.channel;
+
+        // A coroutine that is destroyed while it waits leaves no registration behind
+        if (channel.reader == &waiter) {
+            channel.reader = nullptr;
+        }
+
+        if (channel.writer == &waiter) {
+            channel.writer = nullptr;
+        }
+
+        if (waiter.timed) {
+            loop.timers.erase(waiter.timer);
+        }
+    }
+
+    auto EventLoop::Wait::await_suspend(const std::coroutine_handle<> coroutine) -> bool {
+        Channel &channel = *waiter.channel;
+        Waiter* &slot = waiter.events & EPOLLOUT ? channel.writer : channel.reader;
+
+        // Error if the port got closed or another coroutine already waits in the same direction
+        if (!channel.attached || slot) {
+            waiter.result = status(channel.attached ? StatusCodes::BUSY_ERROR : StatusCodes::CANCELLED_ERROR);
+            return false;
+        }
+
+        waiter.coroutine = coroutine;
+        slot = &waiter;
+
+        if (timeout >= 0) {
+            waiter.timed = true;
+            waiter.timer = TimerId(Clock::now() + std::chrono::milliseconds(timeout), loop.nextTimer++);
+            loop.timers.emplace(waiter.timer, &waiter);
+        }
+
+        loop.arm(channel);
+
+        return true;
+    }
+
+    EventLoop::EventLoop() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        // The wake up descriptor is the only registration without a channel
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.ptr = nullptr;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+    }
+
+    EventLoop::~EventLoop() {
+        ::close(wakeFd);
+        ::close(epollFd);
+    }
+
+    auto EventLoop::spawn(Task<void> task) -> void {
+        if (task.done()) {
+            return;
+        }
+
+        task.promise->detached = true;
+        const std::coroutine_handle<> coroutine = std::exchange(task.coroutine, {});
+
+        ready.push_back(coroutine);
+    }
+
+    auto EventLoop::run() -> void {
+        while (!stopping) {
+            turn();
+        }
+
+        stopping = false;
+    }
+
+    auto EventLoop::stop() -> void {
+        stopping = true;
+
+        const std::uint64_t one = 1;
+        [[maybe_unused]] const ssize_t written = ::write(wakeFd, &one, sizeof(one));
+    }
+
+    auto EventLoop::attach(Channel &channel, const int fd) -> bool {
+        epoll_event event{};
+        event.events = EPOLLONESHOT;
+        event.data.ptr = &channel;
+
+        // Error if the file descriptor can not be watched
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return false;
+        }
+
+        channel.fd = fd;
+        channel.attached = true;
+
+        return true;
+    }
+
+    auto EventLoop::detach(Channel &channel) -> void {
+        if (!channel.attached) {
+            return;
+        }
+
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, channel.fd, nullptr);
+        channel.attached = false;
+
+        cancel(channel);
+    }
+
+    auto EventLoop::cancel(Channel &channel) -> void {
+        const int cancelled = status(StatusCodes::CANCELLED_ERROR);
+
+        if (channel.reader) {
+            complete(*channel.reader, cancelled);
+        }
+
+        if (channel.writer) {
+            complete(*channel.writer, cancelled);
+        }
+    }
+
+    auto EventLoop::wait(Channel &channel, const std::uint32_t events, const int timeout) -> Wait {
+        return Wait(*this, channel, events, timeout);
+    }
+
+    /**
+    * @brief Waits for the next events or the earliest deadline once, then resumes what became ready.
+    * Nothing is waited for if coroutines are ready already or the loop is stopping.
+    */
+    auto EventLoop::turn() -> void {
+        epoll_event events[maxEvents];
+        const int count = epoll_wait(epollFd, events, maxEvents, ready.empty() && !stopping ? nextTimeout() : 0);
+
+        for (int i = 0; i < count; i++) {
+            Channel *channel = static_cast<Channel*>(events[i].data.ptr);
+
+            if (!channel) {
+                std::uint64_t value;
+                [[maybe_unused]] const ssize_t bytes = ::read(wakeFd, &value, sizeof(value));
+                continue;
+            }
+
+            const std::uint32_t occurred = events[i].events;
+            const std::uint32_t failed = EPOLLHUP | EPOLLERR;
+
+            if (channel->reader && (occurred & (EPOLLIN | failed))) {
+                complete(*channel->reader, static_cast<int>(occurred));
+            }
+
+            if (channel->writer && (occurred & (EPOLLOUT | failed))) {
+                complete(*channel->writer, static_cast<int>(occurred));
+            }
+
+            // The registration is disarmed after every event, a waiter that is left needs it again
+            arm(*channel);
+        }
+
+        const auto now = Clock::now();
+
+        while (!timers.empty() && timers.begin()->first.first <= now) {
+            Waiter &waiter = *timers.begin()->second;
+            complete(waiter, 0);
+            arm(*waiter.channel);
+        }
+
+        resumeReady();
+    }
+
+    auto EventLoop::arm(Channel &channel) -> void {
+        // Without waiters the registration stays disarmed, a hangup would otherwise be reported on every turn
+        if (!channel.attached || (!channel.reader && !channel.writer)) {
+            return;
+        }
+
+        epoll_event event{};
+        event.events = EPOLLONESHOT
+            | (channel.reader ? static_cast<std::uint32_t>(EPOLLIN) : 0)
+            | (channel.writer ? static_cast<std::uint32_t>(EPOLLOUT) : 0);
+        event.data.ptr = &channel;
+
+        epoll_ctl(epollFd, EPOLL_CTL_MOD, channel.fd, &event);
+    }
+
+    auto EventLoop::complete(Waiter &waiter, const int result) -> void {
+        Channel &channel = *waiter.channel;
+
+        if (channel.reader == &waiter) {
+            channel.reader = nullptr;
+        }
+
+        if (channel.writer == &waiter) {
+            channel.writer = nullptr;
+        }
+
+        if (waiter.timed) {
+            timers.erase(waiter.timer);
+            waiter.timed = false;
+        }
+
+        waiter.result = result;
+        ready.push_back(waiter.coroutine);
+    }
+
+    auto EventLoop::resumeReady() -> void {
+        // Coroutines that become ready while these run wait for the next turn
+        std::swap(ready, resuming);
+
+        for (const std::coroutine_handle<> coroutine : resuming) {
+            coroutine.resume();
+        }
+
+        resuming.clear();
+    }
+
+    auto EventLoop::nextTimeout() const -> int {
+        if (timers.empty()) {
+            return -1;
+        }
+
+        const auto remaining = timers.begin()->first.first - Clock::now();
+
+        return static_cast<int>(std::max<long long>(0, std::chrono::ceil<std::chrono::milliseconds>(remaining).count()));
+    }
+}
+#endif
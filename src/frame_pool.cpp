@@ -0,0 +1,77 @@
+#include "frame_pool.h"
+
+#include <new>
+
+namespace serial {
+
+    auto FramePool::allocate(FramePool* pool, const std::size_t size) -> void* {
+        const std::size_t total = sizeof(Header) + size;
+
+        // Frames that are too large for a size class come from the heap
+        if (!pool || total > maxFrameSize) {
+            Header *header = static_cast<Header*>(::operator new(total));
+            header->pool = nullptr;
+            header->sizeClass = 0;
+            return header + 1;
+        }
+
+        const std::size_t sizeClass = (total + granularity - 1) / granularity;
+        Header *header;
+
+        if (pool->freeFrames[sizeClass]) {
+            FreeFrame *frame = pool->freeFrames[sizeClass];
+            pool->freeFrames[sizeClass] = frame->next;
+            header = reinterpret_cast<Header*>(frame);
+        } else {
+            header = static_cast<Header*>(::operator new(sizeClass * granularity));
+            pool->heapAllocations++;
+        }
+
+        header->pool = pool;
+        header->sizeClass = sizeClass;
+        pool->inUse++;
+
+        return header + 1;
+    }
+
+    auto FramePool::deallocate(void* frame) -> void {
+        Header *header = static_cast<Header*>(frame) - 1;
+        FramePool *pool = header->pool;
+
+        if (!pool) {
+            ::operator delete(header);
+            return;
+        }
+
+        FreeFrame *freeFrame = reinterpret_cast<FreeFrame*>(header);
+        freeFrame->next = pool->freeFrames[header->sizeClass];
+        pool->freeFrames[header->sizeClass] = freeFrame;
+        pool->inUse--;
+
+        if (pool->released && pool->inUse == 0) {
+            delete pool;
+        }
+    }
+
+    auto FramePool::release() -> void {
+        released = true;
+
+        if (inUse == 0) {
+            delete this;
+        }
+    }
+
+    auto FramePool::allocations() const -> std::uint64_t {
+        return heapAllocations;
+    }
+
+    FramePool::~FramePool() {
+        for (FreeFrame *frame : freeFrames) {
+            while (frame) {
+                FreeFrame *next = frame->next;
+                ::operator delete(frame);
+                frame = next;
+            }
+        }
+    }
+}
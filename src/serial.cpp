@@ -1,51 +1,366 @@
 #include "serial.h"
+#include "completion_queue.h"
 
-auto open(
+#include <string>
+
+// Windows
+#if defined(_WIN32) || defined(__WIN32__) || defined(WIN32)
+    #include "serial_windows.h"
+    #define _open(port, baudrate, dataBits, parity, stopBits, engine, receiveBufferSize) WindowsSystem::open(port, baudrate, dataBits, parity, stopBits, engine, receiveBufferSize)
+    #define _close(handle) WindowsSystem::close(handle)
+    #define _cancel(handle) WindowsSystem::cancel(handle)
+    #define _read(handle, buffer, bufferSize, timeout, multiplier) WindowsSystem::read(handle, buffer, bufferSize, timeout, multiplier)
+    #define _readUntil(handle, buffer, bufferSize, timeout, multiplier, untilChar) WindowsSystem::readUntil(handle, buffer, bufferSize, timeout, multiplier, untilChar)
+    #define _readLines(handle, buffer, bufferSize, offsets, maxLines, timeout, multiplier, untilChar) WindowsSystem::readLines(handle, buffer, bufferSize, offsets, maxLines, timeout, multiplier, untilChar)
+    #define _write(handle, buffer, bufferSize, timeout, multiplier) WindowsSystem::write(handle, buffer, bufferSize, timeout, multiplier)
+    #define _readv(handle, segments, segmentCount, timeout, multiplier) WindowsSystem::readv(handle, segments, segmentCount, timeout, multiplier)
+    #define _writev(handle, segments, segmentCount, timeout, multiplier) WindowsSystem::writev(handle, segments, segmentCount, timeout, multiplier)
+    #define _transact(handle, request, requestSize, response, responseSize, timeout, multiplier, untilChar, result, resultSize) WindowsSystem::transact(handle, request, requestSize, response, responseSize, timeout, multiplier, untilChar, result, resultSize)
+    #define _configureWriteQueue(handle, capacity, coalesceBytes, coalesceDelay, sliceSize) WindowsSystem::configureWriteQueue(handle, capacity, coalesceBytes, coalesceDelay, sliceSize)
+    #define _enqueueWrite(handle, buffer, bufferSize, priority, timeout) WindowsSystem::enqueueWrite(handle, buffer, bufferSize, priority, timeout)
+    #define _flushWriteQueue(handle, timeout) WindowsSystem::flushWriteQueue(handle, timeout)
+    #define _getWriteQueueStatus(handle, buffer, bufferSize) WindowsSystem::getWriteQueueStatus(handle, buffer, bufferSize)
+    #define _setPacing(handle, budget) WindowsSystem::setPacing(handle, budget)
+    #define _setCanonicalLines(handle, enabled) WindowsSystem::setCanonicalLines(handle, enabled)
+    #define _getOutputBacklog(handle) WindowsSystem::getOutputBacklog(handle)
+    #define _drain(handle, timeout) WindowsSystem::drain(handle, timeout)
+    #define _tuneLatency(handle, latencyTimer, lowLatency, sysfsRoot, result, resultSize) WindowsSystem::tuneLatency(handle, latencyTimer, lowLatency, sysfsRoot, result, resultSize)
+    #define _getBaudrate(handle) WindowsSystem::getBaudrate(handle)
+    #define _getStats(handle, buffer, bufferSize) WindowsSystem::getStats(handle, buffer, bufferSize)
+    #define _mapReceiveRing(handle, descriptor, descriptorSize) WindowsSystem::mapReceiveRing(handle, descriptor, descriptorSize)
+    #define _getAvailablePorts(buffer, bufferSize, separator) WindowsSystem::getAvailablePorts(buffer, bufferSize, separator)
+    #define _enumeratePorts(buffer, bufferSize, sysfsRoot) WindowsSystem::enumeratePorts(buffer, bufferSize, sysfsRoot)
+    #define _portsGeneration() WindowsSystem::portsGeneration()
+    #define _waitPortsChanged(generation, timeout) WindowsSystem::waitPortsChanged(generation, timeout)
+#endif
+
+// Linux, Apple
+#if defined(__unix__) || defined(__unix) || defined(__APPLE__)
+    #include "serial_unix.h"
+    #define _open(port, baudrate, dataBits, parity, stopBits, engine, receiveBufferSize) UnixSystem::open(port, baudrate, dataBits, parity, stopBits, engine, receiveBufferSize)
+    #define _close(handle) UnixSystem::close(handle)
+    #define _cancel(handle) UnixSystem::cancel(handle)
+    #define _read(handle, buffer, bufferSize, timeout, multiplier) UnixSystem::read(handle, buffer, bufferSize, timeout, multiplier)
+    #define _readUntil(handle, buffer, bufferSize, timeout, multiplier, untilChar) UnixSystem::readUntil(handle, buffer, bufferSize, timeout, multiplier, untilChar)
+    #define _readLines(handle, buffer, bufferSize, offsets, maxLines, timeout, multiplier, untilChar) UnixSystem::readLines(handle, buffer, bufferSize, offsets, maxLines, timeout, multiplier, untilChar)
+    #define _write(handle, buffer, bufferSize, timeout, multiplier) UnixSystem::write(handle, buffer, bufferSize, timeout, multiplier)
+    #define _readv(handle, segments, segmentCount, timeout, multiplier) UnixSystem::readv(handle, segments, segmentCount, timeout, multiplier)
+    #define _writev(handle, segments, segmentCount, timeout, multiplier) UnixSystem::writev(handle, segments, segmentCount, timeout, multiplier)
+    #define _transact(handle, request, requestSize, response, responseSize, timeout, multiplier, untilChar, result, resultSize) UnixSystem::transact(handle, request, requestSize, response, responseSize, timeout, multiplier, untilChar, result, resultSize)
+    #define _configureWriteQueue(handle, capacity, coalesceBytes, coalesceDelay, sliceSize) UnixSystem::configureWriteQueue(handle, capacity, coalesceBytes, coalesceDelay, sliceSize)
+    #define _enqueueWrite(handle, buffer, bufferSize, priority, timeout) UnixSystem::enqueueWrite(handle, buffer, bufferSize, priority, timeout)
+    #define _flushWriteQueue(handle, timeout) UnixSystem::flushWriteQueue(handle, timeout)
+    #define _getWriteQueueStatus(handle, buffer, bufferSize) UnixSystem::getWriteQueueStatus(handle, buffer, bufferSize)
+    #define _setPacing(handle, budget) UnixSystem::setPacing(handle, budget)
+    #define _setCanonicalLines(handle, enabled) UnixSystem::setCanonicalLines(handle, enabled)
+    #define _getOutputBacklog(handle) UnixSystem::getOutputBacklog(handle)
+    #define _drain(handle, timeout) UnixSystem::drain(handle, timeout)
+    #define _tuneLatency(handle, latencyTimer, lowLatency, sysfsRoot, result, resultSize) UnixSystem::tuneLatency(handle, latencyTimer, lowLatency, sysfsRoot, result, resultSize)
+    #define _getBaudrate(handle) UnixSystem::getBaudrate(handle)
+    #define _getStats(handle, buffer, bufferSize) UnixSystem::getStats(handle, buffer, bufferSize)
+    #define _mapReceiveRing(handle, descriptor, descriptorSize) UnixSystem::mapReceiveRing(handle, descriptor, descriptorSize)
+    #define _getAvailablePorts(buffer, bufferSize, separator) UnixSystem::getAvailablePorts(buffer, bufferSize, separator)
+    #define _enumeratePorts(buffer, bufferSize, sysfsRoot) UnixSystem::enumeratePorts(buffer, bufferSize, sysfsRoot)
+    #define _portsGeneration() UnixSystem::portsGeneration()
+    #define _waitPortsChanged(generation, timeout) UnixSystem::waitPortsChanged(generation, timeout)
+#endif
+
+auto serialOpen(
     void* port,
     const int baudrate,
     const int dataBits,
     const int parity,
-    const int stopBits
+    const int stopBits,
+    const int engine,
+    const int receiveBufferSize
 ) -> int {
-    return _open(port, baudrate, dataBits, parity, stopBits);
+    return _open(port, baudrate, dataBits, parity, stopBits, engine, receiveBufferSize);
 }
 
-auto close() -> int {
-    return _close();
+auto serialClose(
+    const int handle
+) -> int {
+    return _close(handle);
+}
+
+auto serialCancel(
+    const int handle
+) -> int {
+    return _cancel(handle);
 }
 
-auto read(
+auto serialRead(
+    const int handle,
     void* buffer,
     const int bufferSize,
     const int timeout,
     const int multiplier
 ) -> int {
-    return _read(buffer, bufferSize, timeout, multiplier);
+    return _read(handle, buffer, bufferSize, timeout, multiplier);
+}
+
+auto serialReadUntil(
+    const int handle,
+    void* buffer,
+    const int bufferSize,
+    const int timeout,
+    const int multiplier,
+    void* untilChar
+) -> int {
+    return _readUntil(handle, buffer, bufferSize, timeout, multiplier, untilChar);
 }
 
-auto readUntil(
+auto serialReadLines(
+    const int handle,
     void* buffer,
     const int bufferSize,
+    void* offsets,
+    const int maxLines,
     const int timeout,
     const int multiplier,
     void* untilChar
 ) -> int {
-    return _readUntil(buffer, bufferSize, timeout, multiplier, untilChar);
+    return _readLines(handle, buffer, bufferSize, offsets, maxLines, timeout, multiplier, untilChar);
 }
 
-auto write(
+auto serialWrite(
+    const int handle,
     void* buffer,
     const int bufferSize,
     const int timeout,
     const int multiplier
 ) -> int {
-    return _write(buffer, bufferSize, timeout, multiplier);
+    return _write(handle, buffer, bufferSize, timeout, multiplier);
+}
+
+auto serialReadv(
+    const int handle,
+    void* segments,
+    const int segmentCount,
+    const int timeout,
+    const int multiplier
+) -> int {
+    return _readv(handle, segments, segmentCount, timeout, multiplier);
+}
+
+auto serialWritev(
+    const int handle,
+    void* segments,
+    const int segmentCount,
+    const int timeout,
+    const int multiplier
+) -> int {
+    return _writev(handle, segments, segmentCount, timeout, multiplier);
+}
+
+auto serialTransact(
+    const int handle,
+    void* request,
+    const int requestSize,
+    void* response,
+    const int responseSize,
+    const int timeout,
+    const int multiplier,
+    void* untilChar,
+    void* result,
+    const int resultSize
+) -> int {
+    return _transact(handle, request, requestSize, response, responseSize, timeout, multiplier, untilChar, result, resultSize);
 }
 
-auto getAvailablePorts(
+auto serialConfigureWriteQueue(
+    const int handle,
+    const int capacity,
+    const int coalesceBytes,
+    const int coalesceDelay,
+    const int sliceSize
+) -> int {
+    return _configureWriteQueue(handle, capacity, coalesceBytes, coalesceDelay, sliceSize);
+}
+
+auto serialEnqueueWrite(
+    const int handle,
+    void* buffer,
+    const int bufferSize,
+    const int priority,
+    const int timeout
+) -> int {
+    return _enqueueWrite(handle, buffer, bufferSize, priority, timeout);
+}
+
+auto serialFlushWriteQueue(
+    const int handle,
+    const int timeout
+) -> int {
+    return _flushWriteQueue(handle, timeout);
+}
+
+auto serialGetWriteQueueStatus(
+    const int handle,
+    void* buffer,
+    const int bufferSize
+) -> int {
+    return _getWriteQueueStatus(handle, buffer, bufferSize);
+}
+
+auto serialSetPacing(
+    const int handle,
+    const int budget
+) -> int {
+    return _setPacing(handle, budget);
+}
+
+auto serialSetCanonicalLines(
+    const int handle,
+    const int enabled
+) -> int {
+    return _setCanonicalLines(handle, enabled);
+}
+
+auto serialGetOutputBacklog(
+    const int handle
+) -> int {
+    return _getOutputBacklog(handle);
+}
+
+auto serialDrain(
+    const int handle,
+    const int timeout
+) -> int {
+    return _drain(handle, timeout);
+}
+
+/*
+* The submitted operations run the synchronous calls on the read or the write
+* worker of the port. Buffers have to stay valid until the completion was picked
+* up, the delimiter of readUntil is copied right away. A submission fails with
+* `BUFFER_ERROR` while too many completions are waiting to be picked up.
+*/
+auto serialSubmitRead(
+    const int handle,
+    const unsigned int requestId,
+    void* buffer,
+    const int bufferSize,
+    const int timeout,
+    const int multiplier
+) -> int {
+    const bool queued = CompletionQueue::instance().submit(handle, CompletionQueue::Lane::READ, requestId, [=] {
+        return _read(handle, buffer, bufferSize, timeout, multiplier);
+    });
+
+    // Error if too many requests have not been picked up yet
+    if (!queued) {
+        return status(StatusCodes::BUFFER_ERROR);
+    }
+
+    return status(StatusCodes::SUCCESS);
+}
+
+auto serialSubmitReadUntil(
+    const int handle,
+    const unsigned int requestId,
+    void* buffer,
+    const int bufferSize,
+    const int timeout,
+    const int multiplier,
+    void* untilChar
+) -> int {
+    const bool queued = CompletionQueue::instance().submit(handle, CompletionQueue::Lane::READ, requestId, [=, delimiter = std::string(static_cast<char*>(untilChar))] {
+        return _readUntil(handle, buffer, bufferSize, timeout, multiplier, const_cast<char*>(delimiter.c_str()));
+    });
+
+    // Error if too many requests have not been picked up yet
+    if (!queued) {
+        return status(StatusCodes::BUFFER_ERROR);
+    }
+
+    return status(StatusCodes::SUCCESS);
+}
+
+auto serialSubmitWrite(
+    const int handle,
+    const unsigned int requestId,
+    void* buffer,
+    const int bufferSize,
+    const int timeout,
+    const int multiplier
+) -> int {
+    const bool queued = CompletionQueue::instance().submit(handle, CompletionQueue::Lane::WRITE, requestId, [=] {
+        return _write(handle, buffer, bufferSize, timeout, multiplier);
+    });
+
+    // Error if too many requests have not been picked up yet
+    if (!queued) {
+        return status(StatusCodes::BUFFER_ERROR);
+    }
+
+    return status(StatusCodes::SUCCESS);
+}
+
+auto serialWaitCompletions(
+    void* completions,
+    const int maxCompletions,
+    const int timeout
+) -> int {
+    return CompletionQueue::instance().wait(static_cast<Completion*>(completions), maxCompletions, timeout);
+}
+
+auto serialTuneLatency(
+    const int handle,
+    const int latencyTimer,
+    const int lowLatency,
+    void* sysfsRoot,
+    void* result,
+    const int resultSize
+) -> int {
+    return _tuneLatency(handle, latencyTimer, lowLatency, sysfsRoot, result, resultSize);
+}
+
+auto serialGetBaudrate(
+    const int handle
+) -> int {
+    return _getBaudrate(handle);
+}
+
+auto serialGetStats(
+    const int handle,
+    void* buffer,
+    const int bufferSize
+) -> int {
+    return _getStats(handle, buffer, bufferSize);
+}
+
+auto serialMapReceiveRing(
+    const int handle,
+    void* descriptor,
+    const int descriptorSize
+) -> int {
+    return _mapReceiveRing(handle, descriptor, descriptorSize);
+}
+
+auto serialGetAvailablePorts(
     void* buffer,
     const int bufferSize,
     void* separator
 ) -> int {
     return _getAvailablePorts(buffer, bufferSize, separator);
 }
+
+auto serialEnumeratePorts(
+    void* buffer,
+    const int bufferSize,
+    void* sysfsRoot
+) -> int {
+    return _enumeratePorts(buffer, bufferSize, sysfsRoot);
+}
+
+auto serialPortsGeneration() -> int {
+    return _portsGeneration();
+}
+
+auto serialWaitPortsChanged(
+    const int generation,
+    const int timeout
+) -> int {
+    return _waitPortsChanged(generation, timeout);
+}
@@ -0,0 +1,432 @@
+#if defined(__linux__)
+#include "serial_port.h"
+#include "serial_unix.h"
+
+#include <mutex>
+#include <sys/epoll.h>
+
+namespace serial {
+
+    // Spans beyond this size can not be reported by the counts of the port statistics
+    constexpr std::size_t maxTransferSize = static_cast<std::size_t>(INT_MAX);
+
+    struct Port::State {
+        State(EventLoop &loop, std::shared_ptr<UnixSystem::Port> port, const int handle) :
+            loop(loop),
+            port(std::move(port)),
+            handle(handle) {}
+
+        ~State() {
+            loop.detach(channel);
+            frames->release();
+        }
+
+        auto framePool() const -> FramePool* {
+            return frames;
+        }
+
+        static auto receive(State &state, char* destination, int size, Deadline &deadline) -> Task<int>;
+        static auto send(State &state, const char* source, int size, Deadline &deadline) -> Task<int>;
+
+        static auto read(std::shared_ptr<State> state, std::span<std::byte> buffer, int timeout, int multiplier) -> Task<Result<std::size_t>>;
+        static auto readUntil(
+            std::shared_ptr<State> state,
+            std::span<std::byte> buffer,
+            std::string_view delimiter,
+            int timeout,
+            int multiplier
+        ) -> Task<Result<std::size_t>>;
+        static auto write(std::shared_ptr<State> state, std::span<const std::byte> buffer, int timeout, int multiplier) -> Task<Result<std::size_t>>;
+        static auto transact(
+            std::shared_ptr<State> state,
+            std::span<const std::byte> request,
+            std::span<std::byte> response,
+            std::string_view delimiter,
+            int timeout,
+            int multiplier
+        ) -> Task<Result<std::size_t>>;
+
+        EventLoop &loop;
+        std::shared_ptr<UnixSystem::Port> port;
+        int handle;
+        EventLoop::Channel channel;
+        FramePool* frames{new FramePool()};
+    };
+
+    /**
+    * @brief Reads the bytes that are available, waiting for the first ones until the deadline has passed.
+    * @return Returns the number of bytes read, `0` on timeout or a negative status code
+    */
+    auto Port::State::receive(State &state, char* destination, const int size, Deadline &deadline) -> Task<int> {
+        bool hungUp = false;
+
+        while (true) {
+            const ssize_t bytesRead = ::read(state.channel.fd, destination, static_cast<std::size_t>(size));
+
+            if (bytesRead > 0) {
+                deadline.progress();
+                co_return static_cast<int>(bytesRead);
+            }
+
+            // Error if the tty can not be read or hung up, a tty without VMIN reads nothing after a hangup
+            if ((bytesRead < 0 && errno != EAGAIN && errno != EINTR) || hungUp) {
+                co_return status(StatusCodes::READ_ERROR);
+            }
+
+            const int remaining = deadline.remaining();
+
+            if (remaining == 0) {
+                co_return 0;
+            }
+
+            const int events = co_await state.loop.wait(state.channel, EPOLLIN, remaining);
+
+            // Error if the wait got cancelled
+            if (events < 0) {
+                co_return events;
+            }
+
+            hungUp = (events & (EPOLLHUP | EPOLLERR)) != 0;
+        }
+    }
+
+    /**
+    * @brief Writes the bytes, waiting for room in the output queue of the tty until the deadline has passed.
+    * @return Returns the status code of the failed write (negative) or the number of bytes written
+    */
+    auto Port::State::send(State &state, const char* source, const int size, Deadline &deadline) -> Task<int> {
+        int written = 0;
+
+        while (written < size) {
+            const ssize_t bytesWritten = ::write(state.channel.fd, source + written, static_cast<std::size_t>(size - written));
+
+            if (bytesWritten > 0) {
+                written += static_cast<int>(bytesWritten);
+                deadline.progress();
+                continue;
+            }
+
+            // Error if the tty can not be written, the bytes written so far are reported instead
+            if (bytesWritten < 0 && errno != EAGAIN && errno != EINTR) {
+                co_return written > 0 ? written : status(StatusCodes::WRITE_ERROR);
+            }
+
+            const int remaining = deadline.remaining();
+
+            if (remaining == 0) {
+                break;
+            }
+
+            const int events = co_await state.loop.wait(state.channel, EPOLLOUT, remaining);
+
+            // Error if the wait got cancelled
+            if (events < 0) {
+                co_return written > 0 ? written : events;
+            }
+        }
+
+        co_return written;
+    }
+
+    auto Port::State::read(
+        std::shared_ptr<State> state,
+        const std::span<std::byte> buffer,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        // Error if the port is not open
+        if (!state) {
+            co_return Failure{StatusCodes::INVALID_HANDLE_ERROR};
+        }
+
+        // Error if the buffer is too large
+        if (buffer.size() > maxTransferSize) {
+            co_return Failure{StatusCodes::BUFFER_ERROR};
+        }
+
+        std::unique_lock lock(state->port->readMutex, std::try_to_lock);
+
+        // Error if a read through the handle of the port is running, it owns the pushback buffer and the matcher
+        if (!lock) {
+            co_return Failure{StatusCodes::BUSY_ERROR};
+        }
+
+        const auto start = PortStats::Clock::now();
+        const int size = static_cast<int>(buffer.size());
+        char *destination = reinterpret_cast<char*>(buffer.data());
+        Deadline deadline = Deadline::forRead(timeout, multiplier, size);
+
+        // Bytes read ahead by a previous readUntil come first
+        int filled = static_cast<int>(state->port->pushback.take(destination, buffer.size()));
+
+        if (filled > 0) {
+            deadline.progress();
+        }
+
+        while (filled < size) {
+            const int bytesRead = co_await receive(*state, destination + filled, size - filled, deadline);
+
+            // Error if read fails, the bytes received so far are handed out first
+            if (bytesRead < 0) {
+                filled = filled > 0 ? filled : bytesRead;
+                break;
+            }
+
+            if (bytesRead == 0) {
+                break;
+            }
+
+            filled += bytesRead;
+        }
+
+        state->port->stats.recordRead(start, size, filled);
+
+        co_return resultOf(filled);
+    }
+
+    /**
+    * @brief Reads until the delimiter like `readUntilDelimiter`, whose read callback can not suspend.
+    */
+    auto Port::State::readUntil(
+        std::shared_ptr<State> state,
+        const std::span<std::byte> buffer,
+        const std::string_view delimiter,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        // Error if the port is not open
+        if (!state) {
+            co_return Failure{StatusCodes::INVALID_HANDLE_ERROR};
+        }
+
+        // Error if the buffer is too large
+        if (buffer.size() > maxTransferSize) {
+            co_return Failure{StatusCodes::BUFFER_ERROR};
+        }
+
+        std::unique_lock lock(state->port->readMutex, std::try_to_lock);
+
+        // Error if a read through the handle of the port is running, it owns the pushback buffer and the matcher
+        if (!lock) {
+            co_return Failure{StatusCodes::BUSY_ERROR};
+        }
+
+        const auto start = PortStats::Clock::now();
+        const int size = static_cast<int>(buffer.size());
+        char *destination = reinterpret_cast<char*>(buffer.data());
+        Deadline deadline = Deadline::forRead(timeout, multiplier, size);
+
+        PushbackBuffer &pushback = state->port->pushback;
+        DelimiterMatcher &matcher = state->port->delimiterMatcher;
+
+        // The matcher is cached on the port and only rebuilt when the delimiter changes
+        matcher.compile(delimiter.data(), delimiter.size());
+        matcher.reset();
+
+        int filled = static_cast<int>(pushback.take(destination, buffer.size()));
+        int scanned = 0;
+        int result = 0;
+
+        while (true) {
+            const std::size_t matchEnd = matcher.feed(destination + scanned, static_cast<std::size_t>(filled - scanned));
+
+            if (matchEnd != DelimiterMatcher::npos) {
+                const int end = scanned + static_cast<int>(matchEnd);
+                pushback.pushFront(destination + end, static_cast<std::size_t>(filled - end));
+                filled = end;
+                break;
+            }
+
+            scanned = filled;
+
+            if (filled == size) {
+                break;
+            }
+
+            const int bytesRead = co_await receive(*state, destination + filled, size - filled, deadline);
+
+            // Error if read fails, the bytes received so far stay available for the next read
+            if (bytesRead < 0) {
+                pushback.pushFront(destination, static_cast<std::size_t>(filled));
+                result = bytesRead;
+                break;
+            }
+
+            if (bytesRead == 0) {
+                break;
+            }
+
+            filled += bytesRead;
+        }
+
+        result = result < 0 ? result : filled;
+
+        state->port->stats.recordRead(start, size, result);
+
+        co_return resultOf(result);
+    }
+
+    auto Port::State::write(
+        std::shared_ptr<State> state,
+        const std::span<const std::byte> buffer,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        // Error if the port is not open
+        if (!state) {
+            co_return Failure{StatusCodes::INVALID_HANDLE_ERROR};
+        }
+
+        // Error if the buffer is too large
+        if (buffer.size() > maxTransferSize) {
+            co_return Failure{StatusCodes::BUFFER_ERROR};
+        }
+
+        const auto start = PortStats::Clock::now();
+        const int size = static_cast<int>(buffer.size());
+        Deadline deadline = Deadline::forWrite(timeout, multiplier, size);
+
+        const int written = co_await send(*state, reinterpret_cast<const char*>(buffer.data()), size, deadline);
+
+        state->port->stats.recordWrite(start, size, written);
+
+        co_return resultOf(written);
+    }
+
+    auto Port::State::transact(
+        std::shared_ptr<State> state,
+        const std::span<const std::byte> request,
+        const std::span<std::byte> response,
+        const std::string_view delimiter,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        const Result<std::size_t> written = co_await write(state, request, timeout, multiplier);
+
+        // Error if write fails
+        if (!written) {
+            co_return written;
+        }
+
+        co_return co_await readUntil(state, response, delimiter, timeout, multiplier);
+    }
+
+    Port::Port(std::shared_ptr<State> state) : state(std::move(state)) {}
+
+    Port::~Port() {
+        if (state) {
+            static_cast<void>(close());
+        }
+    }
+
+    Port::Port(Port &&other) noexcept : state(std::move(other.state)) {}
+
+    auto Port::operator=(Port &&other) noexcept -> Port& {
+        if (this != &other) {
+            if (state) {
+                static_cast<void>(close());
+            }
+
+            state = std::move(other.state);
+        }
+
+        return *this;
+    }
+
+    auto Port::open(
+        EventLoop &loop,
+        const char* path,
+        const int baudrate,
+        const int dataBits,
+        const int parity,
+        const int stopBits
+    ) -> Result<Port> {
+        // The blocking engine leaves the tty without reader threads or registrations of its own
+        const int handle = UnixSystem::open(
+            const_cast<char*>(path),
+            baudrate,
+            dataBits,
+            parity,
+            stopBits,
+            static_cast<int>(Engines::BLOCKING),
+            0
+        );
+
+        // Error if the port can not be opened
+        if (handle < 0) {
+            return Failure{static_cast<StatusCodes>(handle)};
+        }
+
+        auto port = UnixSystem::ports.find(handle);
+        const int flags = fcntl(port->hSerialPort, F_GETFL);
+        auto state = std::make_shared<State>(loop, port, handle);
+
+        // Error if the tty can not be switched to non-blocking mode or watched by the loop
+        if (flags < 0 || fcntl(port->hSerialPort, F_SETFL, flags | O_NONBLOCK) != 0 || !loop.attach(state->channel, port->hSerialPort)) {
+            UnixSystem::close(handle);
+            return Failure{StatusCodes::SET_PROPERTY_ERROR};
+        }
+
+        return Port(std::move(state));
+    }
+
+    auto Port::close() -> Result<void> {
+        // Error if the port is not open
+        if (!state) {
+            return Failure{StatusCodes::INVALID_HANDLE_ERROR};
+        }
+
+        // Operations that are still running keep the state and the file descriptor until they have returned
+        state->loop.detach(state->channel);
+        const int result = UnixSystem::close(state->handle);
+        state.reset();
+
+        return resultOfStatus(result);
+    }
+
+    auto Port::cancel() -> void {
+        if (state) {
+            state->loop.cancel(state->channel);
+        }
+    }
+
+    auto Port::isOpen() const -> bool {
+        return state != nullptr;
+    }
+
+    auto Port::handle() const -> int {
+        return state ? state->handle : -1;
+    }
+
+    auto Port::framePool() const -> FramePool* {
+        return state ? state->frames : nullptr;
+    }
+
+    auto Port::read(const std::span<std::byte> buffer, const int timeout, const int multiplier) -> Task<Result<std::size_t>> {
+        return State::read(state, buffer, timeout, multiplier);
+    }
+
+    auto Port::readUntil(
+        const std::span<std::byte> buffer,
+        const std::string_view delimiter,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        return State::readUntil(state, buffer, delimiter, timeout, multiplier);
+    }
+
+    auto Port::write(const std::span<const std::byte> buffer, const int timeout, const int multiplier) -> Task<Result<std::size_t>> {
+        return State::write(state, buffer, timeout, multiplier);
+    }
+
+    auto Port::transact(
+        const std::span<const std::byte> request,
+        const std::span<std::byte> response,
+        const std::string_view delimiter,
+        const int timeout,
+        const int multiplier
+    ) -> Task<Result<std::size_t>> {
+        return State::transact(state, request, response, delimiter, timeout, multiplier);
+    }
+}
+#endif
@@ -1,176 +1,2424 @@
 #if defined(__unix__) || defined(__unix) || defined(__APPLE__)
 #include "serial_unix.h"
 
+#include <poll.h>
+#if defined(__linux__)
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
+
 namespace fs = std::filesystem;
 
-int hSerialPort;
-termios2 tty;
-
-auto unixSystemOpen(
-    void* port,
-    const int baudrate,
-    const int dataBits,
-    const int parity,
-    const int stopBits
-) -> int {
-    char *portName = static_cast<char*>(port);
-    // Open new serial connection
-    hSerialPort = open(portName, O_RDWR);
-    
-    // Error if open fails
-    ioctl(hSerialPort, TCGETS2, &tty)
-    // if (tcgetattr(hSerialPort, &tty) != 0) {
-    //     returnStatus(StatusCodes::INVALID_HANDLE_ERROR);
-    // }
-
-    tty.c_cflag &= ~PARENB; // Clear parity bit, disabling parity (most common)
-    tty.c_cflag &= ~CSTOPB; // Clear stop field, only one stop bit used in communication (most common)
-    tty.c_cflag &= ~CSIZE;  // Clear all bits that set the data size
-    tty.c_cflag |= CS8;     // 8 bits per byte (most common)
-    tty.c_cflag &= ~CRTSCTS; // Disable RTS/CTS hardware flow control (most common)
-    tty.c_cflag |= CREAD | CLOCAL; // Turn on READ & ignore ctrl lines (CLOCAL = 1)
-
-    tty.c_lflag &= ~ICANON;
-    tty.c_lflag &= ~ECHO;   // Disable echo
-    tty.c_lflag &= ~ECHOE;  // Disable erasure
-    tty.c_lflag &= ~ECHONL; // Disable new-line echo
-    tty.c_lflag &= ~ISIG;   // Disable interpretation of INTR, QUIT and SUSP
-    tty.c_iflag &= ~(IXON | IXOFF | IXANY); // Turn off s/w flow ctrl
-    tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL); // Disable any special handling of received bytes
-    tty.c_oflag &= ~OPOST; // Prevent special interpretation of output bytes (e.g. newline chars)
-    tty.c_oflag &= ~ONLCR; // Prevent conversion of newline to carriage return/line feed
-
-    tty.c_cc[VTIME] = 10; // Wait for up to 1s (10 deciseconds), returning as soon as any data is received.
-    tty.c_cc[VMIN] = 0;
-
-    // Set in/out baud rate to be 9600
-    // cfsetispeed(&tty, B9600);
-    // cfsetospeed(&tty, B9600);
-    tty.c_ispeed = baudrate;
-    tty.c_ospeed = baudrate;
-
-
-    // Data bits
-    tty.c_cflag     &=  ~CSIZE;			// CSIZE is a mask for the number of bits per character
-    switch(dataBits) {
-        case 5:
-            tty.c_cflag     |=  CS5;
-            break;
-        case 6:
-            tty.c_cflag     |=  CS6;
-            break;
-        case 7:
-            tty.c_cflag     |=  CS7;
-            break;
-        default:
-            tty.c_cflag     |=  CS8;
-            break;
+namespace UnixSystem {
+
+    PortTable<Port> ports;
+
+    // Upper bound of bytes the reactor buffers per port before it stops draining the tty
+    constexpr std::size_t receiveBufferLimit = 1 << 20;
+    constexpr std::size_t receiveChunkSize = 4096;
+
+    // Receive ring size of the buffered engine if the caller does not pick one
+    constexpr std::size_t defaultReceiveRingSize = 64 * 1024;
+
+    // A consumer outside of C++ frees room without telling the reader thread, which then checks on its own
+    constexpr std::chrono::milliseconds mappedRingPollInterval{1};
+
+    // Consecutive readUntil calls with the same single byte delimiter before the tty splits the lines itself
+    constexpr int canonicalModeThreshold = 3;
+
+    // The line discipline holds at most this many bytes of an unfinished line and drops the rest
+    constexpr int canonicalLineLimit = 4095;
+
+    // A single write of the write queue gives up after this long, so a stalled tty can not keep its writer thread from stopping
+    constexpr int writeQueueTimeout = 100;
+
+    Port::~Port() {
+        // The writer thread of the write queue still writes to the port
+        transmitQueue.reset();
+
+#if defined(__linux__)
+        if (readerThread.joinable()) {
+            readerStopping = true;
+
+            const std::uint64_t value = 1;
+            [[maybe_unused]] const ssize_t result = ::write(readerStopFd, &value, sizeof(value));
+
+            {
+                std::lock_guard lock(receiveMutex);
+                receiveSpace.notify_all();
+            }
+
+            readerThread.join();
+        }
+
+        if (readerStopFd >= 0) {
+            ::close(readerStopFd);
+        }
+
+        if (reactorId != 0) {
+            Reactor::instance().remove(reactorId);
+        }
+
+        if (engine == Engines::IO_URING) {
+            Uring::instance()->releaseBuffer(uringReceiveBuffer);
+            Uring::instance()->releaseBuffer(uringTransmitBuffer);
+        }
+#endif
+        if (hSerialPort >= 0) {
+            ::close(hSerialPort);
+        }
     }
 
+    /**
+    * @brief Polls the tty until it is ready for the events, the timeout has passed or `cancel` wakes the wait.
+    * @param error The status code if the tty can not be polled
+    * @return Returns `1` if the tty is ready, `0` on timeout or a negative status code
+    */
+    static auto pollPort(
+        const std::shared_ptr<Port> &port,
+        const short events,
+        const int timeout,
+        const StatusCodes error
+    ) -> int {
+#if defined(__linux__)
+        Cancellation::Wait wait(port->cancellation);
 
-    // parity
-    switch(parity) {
-        case 0:
-            tty.c_cflag     &=  ~PARENB;
-            break;
-        case 1:	
-            tty.c_cflag 	|=   PARENB;
-            tty.c_cflag		&=	 ~PARODD; // Clearing PARODD makes the parity even
-            break;
-        case 2:
-            tty.c_cflag     |=   PARENB;
-            tty.c_cflag		|=	 PARODD;
-            break;
-        default:
-            THROW_EXCEPT("parity_ value not supported!");
+        pollfd descriptors[2] = {
+            {port->hSerialPort, events, 0},
+            {port->cancellation.fd(), POLLIN, 0}
+        };
+
+        const int ready = poll(descriptors, 2, timeout);
 
+        // Error if the wait got cancelled
+        if (wait.cancelled()) {
+            return status(StatusCodes::CANCELLED_ERROR);
+        }
+#else
+        pollfd descriptor{port->hSerialPort, events, 0};
+        const int ready = poll(&descriptor, 1, timeout);
+#endif
+
+        if (ready == 0 || (ready < 0 && errno == EINTR)) {
+            return 0;
+        }
+
+        // Error if the tty can not be polled
+        if (ready < 0) {
+            return status(error);
+        }
+
+        return 1;
     }
 
-    // stop bits
-    // Set num. stop bits
-    switch(stopBits) {
-        case 0:
-            tty.c_cflag     &=  ~CSTOPB;
+#if defined(__linux__)
+    /**
+    * @brief Drains the tty into the receive buffer of the port, runs on the reactor thread.
+    */
+    static auto onReadable(const std::weak_ptr<Port> &weakPort, const std::uint32_t events) -> void {
+        auto port = weakPort.lock();
+        if (!port) {
+            return;
+        }
+
+        std::lock_guard lock(port->receiveMutex);
+
+        std::vector<char> &receiveBuffer = port->receiveBuffer;
+
+        // Drop the bytes that were already handed out before appending new ones
+        if (port->receiveHead > 0) {
+            receiveBuffer.erase(receiveBuffer.begin(), receiveBuffer.begin() + port->receiveHead);
+            port->receiveHead = 0;
+        }
+
+        while (receiveBuffer.size() < receiveBufferLimit) {
+            const std::size_t size = receiveBuffer.size();
+            receiveBuffer.resize(size + std::min(receiveChunkSize, receiveBufferLimit - size));
+
+            const ssize_t bytesRead = ::read(port->hSerialPort, receiveBuffer.data() + size, receiveBuffer.size() - size);
+            receiveBuffer.resize(size + std::max<ssize_t>(bytesRead, 0));
+
+            if (bytesRead > 0) {
+                continue;
+            }
+
+            if (bytesRead == 0 || (errno != EAGAIN && errno != EINTR)) {
+                port->hungUp = true;
+            }
+
+            if (bytesRead < 0 && errno == EINTR) {
+                continue;
+            }
+
             break;
-        // TODO case 1: 1.5 would break the code
-        case 2:
-            tty.c_cflag     |=  CSTOPB;
+        }
+
+        if ((events & (EPOLLHUP | EPOLLERR)) && !(events & EPOLLIN)) {
+            port->hungUp = true;
+        }
+
+        // Stop polling a full or hung up port, level triggered epoll would wake up forever otherwise
+        if (port->hungUp || receiveBuffer.size() >= receiveBufferLimit) {
+            Reactor::instance().modify(port->reactorId, 0);
+            port->receivePaused = true;
+        }
+
+        port->receiveReady.notify_all();
+    }
+
+    /**
+    * @brief Serves a read from the receive buffer of a port that is driven by the reactor.
+    */
+    static auto reactorRead(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        const int timeout
+    ) -> int {
+        std::optional<Cancellation::Wait> wait;
+        std::unique_lock lock(port->receiveMutex);
+
+        auto available = [&port] {
+            return port->receiveBuffer.size() - port->receiveHead;
+        };
+
+        if (available() == 0 && !port->hungUp && timeout > 0) {
+            // Cancel takes the receive mutex to wake the wait, so the wait is registered without it
+            lock.unlock();
+            wait.emplace(port->cancellation);
+            lock.lock();
+
+            auto expired = std::make_shared<bool>(false);
+            std::weak_ptr<Port> weakPort = port;
+
+            // The reactor keeps the deadline, so a waiting read costs no thread of its own beyond the caller
+            const Reactor::TimerId timer = Reactor::instance().addTimer(
+                Reactor::Clock::now() + std::chrono::milliseconds(timeout),
+                [weakPort, expired] {
+                    auto port = weakPort.lock();
+                    if (!port) {
+                        return;
+                    }
+
+                    std::lock_guard lock(port->receiveMutex);
+                    *expired = true;
+                    port->receiveReady.notify_all();
+                }
+            );
+
+            port->receiveReady.wait(lock, [&] {
+                return available() > 0 || port->hungUp || *expired || wait->cancelled();
+            });
+
+            Reactor::instance().cancelTimer(timer);
+
+            // Error if the wait got cancelled before any byte arrived
+            if (available() == 0 && wait->cancelled()) {
+                return status(StatusCodes::CANCELLED_ERROR);
+            }
+        }
+
+        // Error if the device is gone and nothing is left to hand out
+        if (available() == 0 && port->hungUp) {
+            return status(StatusCodes::READ_ERROR);
+        }
+
+        const std::size_t bytesRead = std::min(available(), static_cast<std::size_t>(std::max(bufferSize, 0)));
+        memcpy(buffer, port->receiveBuffer.data() + port->receiveHead, bytesRead);
+        port->receiveHead += bytesRead;
+
+        if (port->receiveHead == port->receiveBuffer.size()) {
+            port->receiveBuffer.clear();
+            port->receiveHead = 0;
+        }
+
+        // Resume draining the tty as soon as there is room again
+        if (port->receivePaused && !port->hungUp && available() < receiveBufferLimit) {
+            port->receivePaused = false;
+            Reactor::instance().modify(port->reactorId, EPOLLIN | EPOLLRDHUP);
+        }
+
+        return static_cast<int>(bytesRead);
+    }
+
+    /**
+    * @brief Drains the tty into the receive ring of the port until the port is closed, runs on the reader thread of the port.
+    */
+    static auto bufferedReaderLoop(Port *port) -> void {
+        SpscRing &ring = *port->receiveRing;
+
+        pollfd descriptors[2] = {
+            {port->hSerialPort, POLLIN, 0},
+            {port->readerStopFd, POLLIN, 0}
+        };
+
+        while (!port->readerStopping.load(std::memory_order_relaxed)) {
+            const std::span<char> space = ring.prepare();
+
+            // Let the kernel buffer the bytes while the consumer makes room
+            if (space.empty()) {
+                port->producerWaiting.store(true);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+
+                auto hasSpace = [&] {
+                    return !ring.prepare().empty() || port->readerStopping.load();
+                };
+
+                std::unique_lock lock(port->receiveMutex);
+                if (port->receiveRingMapped) {
+                    port->receiveSpace.wait_for(lock, mappedRingPollInterval, hasSpace);
+                } else {
+                    port->receiveSpace.wait(lock, hasSpace);
+                }
+                port->producerWaiting.store(false);
+                continue;
+            }
+
+            if (poll(descriptors, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+
+            if (descriptors[1].revents != 0) {
+                return;
+            }
+
+            const ssize_t bytesRead = ::read(port->hSerialPort, space.data(), space.size());
+
+            if (bytesRead > 0) {
+                ring.commit(static_cast<std::size_t>(bytesRead));
+
+                // Only take the lock if the consumer is actually sleeping
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (port->consumerWaiting.load()) {
+                    std::lock_guard lock(port->receiveMutex);
+                    port->receiveReady.notify_all();
+                }
+                continue;
+            }
+
+            if (bytesRead < 0 && (errno == EAGAIN || errno == EINTR)) {
+                continue;
+            }
+
             break;
-        default:
-            THROW_EXCEPT("numStopBits_ value not supported!");
+        }
+
+        // The device is gone, wake the consumer so it does not wait for its timeout
+        std::lock_guard lock(port->receiveMutex);
+        port->hungUp = true;
+        port->receiveReady.notify_all();
     }
 
-    // Save tty settings, also checking for error
-    ioctl(hSerialPort, TCSETS2, &tty);
-}
+    /**
+    * @brief Serves a read from the receive ring of the port, a system call is only needed if the ring is empty.
+    */
+    static auto bufferedRead(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        const int timeout
+    ) -> int {
+        SpscRing &ring = *port->receiveRing;
+        char *destination = static_cast<char*>(buffer);
+        const std::size_t size = static_cast<std::size_t>(std::max(bufferSize, 0));
 
-auto unixSystemClose() -> int {
-    close(hSerialPort);
-}
+        if (ring.readable() == 0 && !port->hungUp && timeout > 0) {
+            Cancellation::Wait wait(port->cancellation);
 
-auto unixSystemRead(
-    void* buffer,
-    const int bufferSize,
-    const int timeout,
-    const int multiplier
-) -> int {
-    return read(hSerialPort, static_cast<char*>(buffer), bufferSize);
-}
+            port->consumerWaiting.store(true);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
 
-auto unixSystemReadUntil(
-    void* buffer,
-    const int bufferSize,
-    const int timeout,
-    const int multiplier,
-    void* searchString
-) -> int {
+            std::unique_lock lock(port->receiveMutex);
+            port->receiveReady.wait_for(lock, std::chrono::milliseconds(timeout), [&] {
+                return ring.readable() > 0 || port->hungUp.load() || wait.cancelled();
+            });
+            port->consumerWaiting.store(false);
 
-}
+            // Error if the wait got cancelled before any byte arrived
+            if (ring.readable() == 0 && wait.cancelled()) {
+                return status(StatusCodes::CANCELLED_ERROR);
+            }
+        }
 
-auto unixSystemWrite(
-    void* buffer,
-    const int bufferSize,
-    const int timeout,
-    const int multiplier
-) -> int {
-    return write(serial_port, static_cast<char*>(buffer), bufferSize);
-}
+        const std::size_t bytesRead = ring.read(destination, size);
+
+        // Error if the device is gone and nothing is left to hand out
+        if (bytesRead == 0 && port->hungUp && ring.readable() == 0) {
+            return status(StatusCodes::READ_ERROR);
+        }
+
+        // Wake the reader thread if it is waiting for room in the ring
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (bytesRead > 0 && port->producerWaiting.load()) {
+            std::lock_guard lock(port->receiveMutex);
+            port->receiveSpace.notify_all();
+        }
+
+        return static_cast<int>(bytesRead);
+    }
+
+    /**
+    * @brief Returns `true` if a read without time to wait would find nothing, the linked timeout of io_uring can not express such a read.
+    */
+    static auto nothingReceived(const std::shared_ptr<Port> &port) -> bool {
+        int bytes = 0;
+
+        return ioctl(port->hSerialPort, FIONREAD, &bytes) == 0 && bytes == 0;
+    }
+
+    /**
+    * @brief Reads through the io_uring, into the registered slot of the port if it has one.
+    * The read waits inside the kernel until its linked timeout fires or cancel aborts it.
+    */
+    static auto uringRead(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        const int timeout
+    ) -> int {
+        Uring &uring = *Uring::instance();
+
+        if (timeout == 0 && nothingReceived(port)) {
+            return 0;
+        }
+
+        Cancellation::Wait wait(port->cancellation);
+        std::lock_guard lock(port->receiveMutex);
+
+        const std::chrono::milliseconds deadline(std::max(timeout, 1));
+        const int slot = port->uringReceiveBuffer;
+        int bytesRead;
+
+        if (slot >= 0) {
+            const unsigned size = static_cast<unsigned>(std::min<std::size_t>(std::max(bufferSize, 0), Uring::bufferSize));
+            bytesRead = uring.read(port->hSerialPort, uring.buffer(slot), size, slot, deadline, &port->uringOperations, &wait);
+
+            if (bytesRead > 0) {
+                memcpy(buffer, uring.buffer(slot), bytesRead);
+            }
+        } else {
+            bytesRead = uring.read(port->hSerialPort, buffer, static_cast<unsigned>(std::max(bufferSize, 0)), -1, deadline, &port->uringOperations, &wait);
+        }
+
+        // Error if cancel aborted the read before any byte arrived
+        if (bytesRead <= 0 && wait.cancelled()) {
+            return status(StatusCodes::CANCELLED_ERROR);
+        }
+
+        // A read that got cancelled by its linked timeout simply timed out
+        if (bytesRead == -ECANCELED || bytesRead == -ETIME || bytesRead == -EINTR) {
+            return 0;
+        }
+
+        // Error if read fails
+        if (bytesRead < 0) {
+            return status(StatusCodes::READ_ERROR);
+        }
+
+        return bytesRead;
+    }
+
+    /**
+    * @brief Writes through the io_uring, staging the data in the registered slot of the port if it has one.
+    */
+    static auto uringWrite(
+        const std::shared_ptr<Port> &port,
+        const char* buffer,
+        const int bufferSize,
+        const Deadline &deadline
+    ) -> int {
+        Uring &uring = *Uring::instance();
+
+        Cancellation::Wait wait(port->cancellation);
+        std::lock_guard lock(port->transmitMutex);
+
+        const int slot = port->uringTransmitBuffer;
+        int bytesWritten = 0;
+
+        while (bytesWritten < bufferSize) {
+            const int remaining = deadline.remaining();
+            if (remaining == 0) {
+                break;
+            }
+
+            // Without a deadline the write goes without a linked timeout
+            const std::chrono::milliseconds timeout(std::max(remaining, 0));
+            int result;
+
+            if (slot >= 0) {
+                const unsigned size = static_cast<unsigned>(std::min<std::size_t>(bufferSize - bytesWritten, Uring::bufferSize));
+                memcpy(uring.buffer(slot), buffer + bytesWritten, size);
+                result = uring.write(port->hSerialPort, uring.buffer(slot), size, slot, timeout, &port->uringOperations, &wait);
+            } else {
+                result = uring.write(port->hSerialPort, buffer + bytesWritten, static_cast<unsigned>(bufferSize - bytesWritten), -1, timeout, &port->uringOperations, &wait);
+            }
+
+            // Error if cancel aborted the write before any byte went out
+            if (result <= 0 && wait.cancelled()) {
+                return bytesWritten > 0 ? bytesWritten : status(StatusCodes::CANCELLED_ERROR);
+            }
+
+            if (result == -ECANCELED || result == -ETIME || result == 0) {
+                break;
+            }
+
+            if (result < 0) {
+                return bytesWritten > 0 ? bytesWritten : status(StatusCodes::WRITE_ERROR);
+            }
+
+            bytesWritten += result;
+        }
+
+        return bytesWritten;
+    }
+#endif
+
+    /**
+    * @brief Writes to the non-blocking tty, waiting for room in the output queue until the deadline has passed.
+    */
+    static auto nonBlockingWrite(
+        const std::shared_ptr<Port> &port,
+        const char* buffer,
+        const int bufferSize,
+        const Deadline &deadline
+    ) -> int {
+        int bytesWritten = 0;
+
+        while (bytesWritten < bufferSize) {
+            const ssize_t result = ::write(port->hSerialPort, buffer + bytesWritten, bufferSize - bytesWritten);
+
+            if (result > 0) {
+                bytesWritten += static_cast<int>(result);
+                continue;
+            }
+
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (result < 0 && errno != EAGAIN) {
+                return bytesWritten > 0 ? bytesWritten : status(StatusCodes::WRITE_ERROR);
+            }
+
+            const int remaining = deadline.remaining();
+            if (remaining == 0) {
+                break;
+            }
+
+            const int ready = pollPort(port, POLLOUT, remaining, StatusCodes::WRITE_ERROR);
+            if (ready < 0) {
+                return bytesWritten > 0 ? bytesWritten : ready;
+            }
+
+            if (ready == 0) {
+                break;
+            }
+        }
+
+        return bytesWritten;
+    }
+
+    /**
+    * @brief Switches the tty between raw mode and canonical mode with the delimiter as `VEOL`.
+    * The switch applies immediately, bytes that were already received stay readable in either mode.
+    */
+    static auto setCanonical(const std::shared_ptr<Port> &port, const bool canonical, const char delimiter) -> bool {
+        termios2 tty = port->tty;
+
+        if (canonical) {
+            tty.c_lflag |= ICANON;
+            tty.c_lflag &= ~IEXTEN; // Disable word erase, reprint and literal next
+
+            // Only the delimiter (and the newline, which always ends a line) may end a line, no other byte is special
+            for (const int special : {VEOF, VEOL2, VERASE, VWERASE, VKILL, VREPRINT, VLNEXT}) {
+                tty.c_cc[special] = _POSIX_VDISABLE;
+            }
+
+            tty.c_cc[VEOL] = static_cast<cc_t>(delimiter);
+        }
+
+        if (ioctl(port->hSerialPort, TCSETS2, &tty) != 0) {
+            return false;
+        }
+
+        port->canonical = canonical;
+
+        return true;
+    }
+
+    /**
+    * @brief Returns `true` if the delimiter can be the `VEOL` of the port without the line discipline acting on it otherwise.
+    * A disabled control character never matches, and signal, flow control and carriage return bytes are consumed or rewritten before a line ends.
+    */
+    static auto fitsLineDelimiter(const std::shared_ptr<Port> &port, const char delimiter) -> bool {
+        const cc_t byte = static_cast<cc_t>(delimiter);
+        const termios2 &tty = port->tty;
+
+        if (byte == _POSIX_VDISABLE) {
+            return false;
+        }
+
+        if ((tty.c_lflag & ISIG) && (byte == tty.c_cc[VINTR] || byte == tty.c_cc[VQUIT] || byte == tty.c_cc[VSUSP])) {
+            return false;
+        }
+
+        if ((tty.c_iflag & IXON) && (byte == tty.c_cc[VSTART] || byte == tty.c_cc[VSTOP])) {
+            return false;
+        }
+
+        if (byte == '\r' && (tty.c_iflag & (ICRNL | IGNCR))) {
+            return false;
+        }
+
+        return !(byte == '\n' && (tty.c_iflag & INLCR));
+    }
+
+    /**
+    * @brief Picks the line mode for the next read, the caller holds the read mutex of the port.
+    *
+    * If the port allows it, a single byte delimiter that readUntil uses again and again moves the tty
+    * into canonical mode, so a read wakes up once per line instead of once per chunk. Any other read switches
+    * back to raw mode. The engines that drain the tty on a thread of their own always stay raw,
+    * and so do buffers that take longer lines than the line discipline can hold and delimiters
+    * that do not fit into `VEOL`.
+    *
+    * @param delimiter The delimiter of the read or `nullptr` for a plain read
+    * @param bufferSize The size of the buffer of the read
+    */
+    static auto selectLineMode(const std::shared_ptr<Port> &port, const char* delimiter, const int bufferSize) -> void {
+        const bool eligible = port->canonicalLines
+            && delimiter != nullptr
+            && delimiter[0] != '\0'
+            && delimiter[1] == '\0'
+            && bufferSize <= canonicalLineLimit
+            && (port->engine == Engines::BLOCKING || port->engine == Engines::IO_URING)
+            && fitsLineDelimiter(port, delimiter[0]);
+
+        if (!eligible || delimiter[0] != port->lineDelimiter) {
+            port->lineDelimiter = eligible ? delimiter[0] : '\0';
+            port->lineDelimiterRepeats = 0;
+
+            if (port->canonical) {
+                setCanonical(port, false, '\0');
+            }
+        }
+
+        if (!eligible) {
+            return;
+        }
+
+        port->lineDelimiterRepeats = std::min(port->lineDelimiterRepeats + 1, canonicalModeThreshold);
+
+        // A failed switch leaves the tty raw, which is always correct, just slower
+        if (!port->canonical && port->lineDelimiterRepeats == canonicalModeThreshold) {
+            setCanonical(port, true, delimiter[0]);
+        }
+    }
+
+    /**
+    * @brief Reads whatever the engine of the port has available, waiting for bytes until the deadline has passed.
+    * Every engine waits with a monotonic deadline, so a read without bytes returns as soon as its time is up.
+    */
+    static auto readSome(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        Deadline &deadline
+    ) -> int {
+        const int timeout = deadline.remaining();
+        int bytesRead;
+
+#if defined(__linux__)
+        if (port->engine == Engines::REACTOR) {
+            bytesRead = reactorRead(port, buffer, bufferSize, timeout);
+        } else if (port->engine == Engines::IO_URING) {
+            bytesRead = uringRead(port, buffer, bufferSize, timeout);
+        } else if (port->engine == Engines::BUFFERED) {
+            bytesRead = bufferedRead(port, buffer, bufferSize, timeout);
+        } else
+#endif
+        {
+            // VMIN and VTIME are zero, the read only takes what poll found
+            const int ready = pollPort(port, POLLIN, timeout, StatusCodes::READ_ERROR);
+            if (ready <= 0) {
+                return ready;
+            }
+
+            const ssize_t result = ::read(port->hSerialPort, static_cast<char*>(buffer), bufferSize);
+
+            // Error if read fails
+            if (result < 0) {
+                return errno == EAGAIN || errno == EINTR ? 0 : status(StatusCodes::READ_ERROR);
+            }
+
+            bytesRead = static_cast<int>(result);
+        }
+
+        if (bytesRead > 0) {
+            deadline.progress();
+        }
+
+        return bytesRead;
+    }
+
+    /**
+    * @brief Reads until the buffer is full or the deadline has passed, the caller holds the read mutex of the port.
+    */
+    static auto receive(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        Deadline &deadline
+    ) -> int {
+        char *destination = static_cast<char*>(buffer);
+        const int size = std::max(bufferSize, 0);
+
+        selectLineMode(port, nullptr, bufferSize);
+
+        // Bytes read ahead by a previous readUntil come first
+        int filled = static_cast<int>(port->pushback.take(destination, static_cast<std::size_t>(size)));
+
+        if (filled > 0) {
+            deadline.progress();
+        }
 
-auto unixSystemGetAvailablePorts(
-    void* buffer,
-    const int bufferSize,
-    void* separator
-) -> int {
-    std::string result;
+        while (filled < size) {
+            const int bytesRead = readSome(port, destination + filled, size - filled, deadline);
 
-    int portsCounter = 0;
+            // Error if read fails, the bytes received so far are handed out first
+            if (bytesRead < 0) {
+                return filled > 0 ? filled : bytesRead;
+            }
+
+            if (bytesRead == 0) {
+                break;
+            }
 
-    fs::path p("/dev/serial/by-id");
-    
-    try {
-        if (!exists(p)) {
-            returnStatus(StatusCodes::NOT_FOUND_ERROR);
+            filled += bytesRead;
         }
-        
-        else {
-            for (auto de : fs::directory_iterator(p)) {
-                if (is_symlink(de.symlink_status())) {
-                    fs::path symlink_points_at = read_symlink(de);
-                    fs::path canonical_path = fs::canonical(p / symlink_points_at);
-                    result += canonical_path.generic_string().append(std::string(static_cast<char*>(separator)));
-                    portsCounter++;
+
+        return filled;
+    }
+
+    /**
+    * @brief Reads until the delimiter, the caller holds the read mutex of the port.
+    */
+    static auto receiveUntil(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        Deadline &deadline,
+        const char* delimiter
+    ) -> int {
+        // The matcher is cached on the port and only rebuilt when the delimiter changes
+        port->delimiterMatcher.compile(delimiter, strlen(delimiter));
+
+        selectLineMode(port, delimiter, bufferSize);
+
+        return readUntilDelimiter(
+            port->pushback,
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(std::max(bufferSize, 0)),
+            port->delimiterMatcher,
+            [&port, &deadline, delimiter](char* destination, const std::size_t size) {
+                const int bytesRead = readSome(port, destination, static_cast<int>(size), deadline);
+
+                // A line that fills the read without ending in the delimiter is longer than the caller reads at once,
+                // raw mode keeps the line discipline from dropping the bytes past its limit
+                if (bytesRead > 0 && bytesRead == static_cast<int>(size) && port->canonical
+                    && destination[bytesRead - 1] != delimiter[0] && destination[bytesRead - 1] != '\n'
+                    && setCanonical(port, false, '\0')) {
+                    port->lineDelimiterRepeats = 0;
+                }
+
+                // An unfinished line is invisible in canonical mode, raw mode hands it out before the read times out.
+                // The delimiter has to repeat again before the tty goes back, a timeout each call would switch twice per call.
+                if (bytesRead == 0 && port->canonical && setCanonical(port, false, '\0')) {
+                    port->lineDelimiterRepeats = 0;
+                    Deadline available = Deadline::forRead(0, 0, 0);
+                    return readSome(port, destination, static_cast<int>(size), available);
                 }
+
+                return bytesRead;
+            }
+        );
+    }
+
+    /**
+    * @brief Writes the buffer with the engine of the port.
+    */
+    static auto writeSome(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        const Deadline &deadline
+    ) -> int {
+#if defined(__linux__)
+        if (port->engine == Engines::IO_URING) {
+            return uringWrite(port, static_cast<char*>(buffer), bufferSize, deadline);
+        }
+#endif
+
+        return nonBlockingWrite(port, static_cast<char*>(buffer), bufferSize, deadline);
+    }
+
+    /**
+    * @brief Wakes every wait that is in progress on the port and returns once all of them have ended.
+    * @return Returns `false` if the waits of the port can not be cancelled
+    */
+    static auto cancelWaits(const std::shared_ptr<Port> &port) -> bool {
+#if defined(__linux__)
+        return port->cancellation.cancel([&port] {
+            // The io_uring operations wait inside the kernel, not on a condition variable or in poll
+            if (port->engine == Engines::IO_URING) {
+                Uring::instance()->cancel(port->uringOperations);
             }
+
+            std::lock_guard lock(port->receiveMutex);
+            port->receiveReady.notify_all();
+        });
+#else
+        return false;
+#endif
+    }
+
+    /**
+    * @brief Returns the number of bytes the tty still has to send or `-1` if the driver does not tell.
+    */
+    static auto outputBacklog(const Port* port) -> int {
+        int bytes = 0;
+
+        if (ioctl(port->hSerialPort, TIOCOUTQ, &bytes) < 0) {
+            return -1;
         }
-    } catch (const fs::filesystem_error &exeption) {
+
+        return bytes;
     }
 
-    if (result.length() + 1 <= bufferSize){
-        memcpy(buffer, result.c_str(), result.length() + 1);
-    } else {
-        returnStatus(StatusCodes::BUFFER_ERROR);
+    /**
+    * @brief Returns the number of bytes the pacing budget of the port lets the tty hold, `0` if the port is not paced.
+    */
+    static auto backlogLimitOf(const Port* port) -> std::size_t {
+        const int budget = port->pacingBudget;
+
+        if (budget == 0) {
+            return 0;
+        }
+
+        return pacingLimit(static_cast<int>(port->tty.c_ospeed), budget);
+    }
+
+    /**
+    * @brief Writes the buffer with the engine of the port, in pieces that stay within the pacing budget if the port has one.
+    */
+    static auto writePaced(
+        const std::shared_ptr<Port> &port,
+        void* buffer,
+        const int bufferSize,
+        const Deadline &deadline
+    ) -> int {
+        const std::size_t limit = backlogLimitOf(port.get());
+
+        if (limit == 0 || bufferSize <= 0) {
+            return writeSome(port, buffer, bufferSize, deadline);
+        }
+
+        return pacedWrite(
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(bufferSize),
+            limit,
+            static_cast<int>(port->tty.c_ospeed),
+            [&] {
+                return outputBacklog(port.get());
+            },
+            [&](const char* data, const std::size_t size) {
+                return writeSome(port, const_cast<char*>(data), static_cast<int>(size), deadline);
+            },
+            deadline
+        );
+    }
+
+    /**
+    * @brief Creates a write queue whose writer thread writes with the engine of the port and paces the bulk bytes by `TIOCOUTQ`.
+    */
+    static auto createTransmitQueue(
+        Port* port,
+        const std::size_t capacity,
+        const std::size_t coalesceBytes,
+        const std::chrono::microseconds coalesceDelay,
+        const std::size_t sliceSize
+    ) -> std::shared_ptr<TransmitQueue> {
+        auto writer = [port](const char* data, const int size) -> int {
+            // The port outlives its queue, so the writer may refer to it without owning it
+            const std::shared_ptr<Port> self(std::shared_ptr<Port>(), port);
+
+            return port->stats.write(size, [&] {
+                const int bytesWritten = writeSome(self, const_cast<char*>(data), size, Deadline::forWrite(writeQueueTimeout, 0, 0));
+
+                // A cancelled wait is retried until the queue stops, the queued bytes are not dropped for it
+                return bytesWritten == status(StatusCodes::CANCELLED_ERROR) ? 0 : bytesWritten;
+            });
+        };
+
+        auto pending = [port]() -> int {
+            return outputBacklog(port);
+        };
+
+        auto queue = std::make_shared<TransmitQueue>(writer, pending, capacity, coalesceBytes, coalesceDelay, sliceSize);
+        queue->setBacklogLimit(backlogLimitOf(port));
+
+        return queue;
+    }
+
+    /**
+    * @brief Returns the write queue of the port, created with the default settings on first use.
+    */
+    static auto transmitQueueOf(const std::shared_ptr<Port> &port) -> std::shared_ptr<TransmitQueue> {
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        if (!port->transmitQueue) {
+            port->transmitQueue = createTransmitQueue(
+                port.get(),
+                TransmitQueue::defaultCapacity,
+                TransmitQueue::defaultCoalesceBytes,
+                TransmitQueue::defaultCoalesceDelay,
+                TransmitQueue::defaultSliceSize
+            );
+        }
+
+        return port->transmitQueue;
+    }
+
+    /**
+    * @brief Converts the `IoSegment` array of the caller into the iovecs of the system calls.
+    * @return Returns `false` if the segments do not fit into a single readv/writev
+    */
+    static auto toIovecs(void* segments, const int segmentCount, std::vector<iovec> &iovecs) -> bool {
+        if (segmentCount < 0 || segmentCount > IOV_MAX) {
+            return false;
+        }
+
+        const IoSegment *segment = static_cast<IoSegment*>(segments);
+
+        iovecs.resize(static_cast<std::size_t>(segmentCount));
+
+        for (std::size_t i{0}; i < iovecs.size(); i++) {
+            iovecs[i].iov_base = reinterpret_cast<void*>(static_cast<std::uintptr_t>(segment[i].address));
+            iovecs[i].iov_len = static_cast<std::size_t>(segment[i].length);
+        }
+
+        return true;
+    }
+
+    /**
+    * @brief Returns the number of bytes the segments hold, capped to what a call can report.
+    */
+    static auto segmentsSize(const std::vector<iovec> &segments) -> int {
+        std::size_t size = 0;
+
+        for (const iovec &segment : segments) {
+            size += segment.iov_len;
+        }
+
+        return static_cast<int>(std::min<std::size_t>(size, INT_MAX));
+    }
+
+    /**
+    * @brief Drops the bytes a partial transfer already moved from the front of the segments.
+    */
+    static auto consumeSegments(iovec* &segments, int &count, std::size_t bytes) -> void {
+        while (count > 0 && bytes >= segments->iov_len) {
+            bytes -= segments->iov_len;
+            segments++;
+            count--;
+        }
+
+        if (count > 0) {
+            segments->iov_base = static_cast<char*>(segments->iov_base) + bytes;
+            segments->iov_len -= bytes;
+        }
+    }
+
+    /**
+    * @brief Scatters a read over the segments with the engine of the port, the caller holds the read mutex of the port.
+    */
+    static auto readSegments(
+        const std::shared_ptr<Port> &port,
+        std::vector<iovec> &segments,
+        Deadline &deadline
+    ) -> int {
+        selectLineMode(port, nullptr, segmentsSize(segments));
+
+        // Bytes read ahead by a previous readUntil come first
+        if (!port->pushback.empty()) {
+            std::size_t bytesRead = 0;
+
+            for (const iovec &segment : segments) {
+                const std::size_t taken = port->pushback.take(static_cast<char*>(segment.iov_base), segment.iov_len);
+                bytesRead += taken;
+
+                if (taken < segment.iov_len) {
+                    break;
+                }
+            }
+
+            return static_cast<int>(bytesRead);
+        }
+
+#if defined(__linux__)
+        if (port->engine == Engines::IO_URING) {
+            const int timeout = deadline.remaining();
+
+            if (timeout == 0 && nothingReceived(port)) {
+                return 0;
+            }
+
+            Cancellation::Wait wait(port->cancellation);
+            std::lock_guard lock(port->receiveMutex);
+
+            const int bytesRead = Uring::instance()->readv(
+                port->hSerialPort,
+                segments.data(),
+                static_cast<unsigned>(segments.size()),
+                std::chrono::milliseconds(std::max(timeout, 1)),
+                &port->uringOperations,
+                &wait
+            );
+
+            // Error if cancel aborted the read before any byte arrived
+            if (bytesRead <= 0 && wait.cancelled()) {
+                return status(StatusCodes::CANCELLED_ERROR);
+            }
+
+            // A read that got cancelled by its linked timeout simply timed out
+            if (bytesRead == -ECANCELED || bytesRead == -ETIME || bytesRead == -EINTR) {
+                return 0;
+            }
+
+            // Error if read fails
+            if (bytesRead < 0) {
+                return status(StatusCodes::READ_ERROR);
+            }
+
+            return bytesRead;
+        }
+
+        // The received bytes already wait in memory, only the first segment waits for them
+        if (port->engine == Engines::REACTOR || port->engine == Engines::BUFFERED) {
+            int bytesRead = 0;
+
+            for (const iovec &segment : segments) {
+                Deadline available = bytesRead == 0 ? deadline : Deadline::forRead(0, 0, 0);
+                const int result = readSome(port, segment.iov_base, static_cast<int>(segment.iov_len), available);
+
+                if (result < 0) {
+                    return bytesRead > 0 ? bytesRead : result;
+                }
+
+                bytesRead += result;
+
+                if (static_cast<std::size_t>(result) < segment.iov_len) {
+                    break;
+                }
+            }
+
+            return bytesRead;
+        }
+#endif
+
+        const int ready = pollPort(port, POLLIN, deadline.remaining(), StatusCodes::READ_ERROR);
+        if (ready <= 0) {
+            return ready;
+        }
+
+        const ssize_t bytesRead = ::readv(port->hSerialPort, segments.data(), static_cast<int>(segments.size()));
+
+        // Error if read fails
+        if (bytesRead < 0) {
+            return errno == EAGAIN || errno == EINTR ? 0 : status(StatusCodes::READ_ERROR);
+        }
+
+        return static_cast<int>(bytesRead);
+    }
+
+    /**
+    * @brief Gathers a write from the segments with the engine of the port.
+    */
+    static auto writeSegments(
+        const std::shared_ptr<Port> &port,
+        std::vector<iovec> &segments,
+        const Deadline &deadline
+    ) -> int {
+        iovec *segment = segments.data();
+        int count = static_cast<int>(segments.size());
+        int bytesWritten = 0;
+
+#if defined(__linux__)
+        if (port->engine == Engines::IO_URING) {
+            Uring &uring = *Uring::instance();
+
+            Cancellation::Wait wait(port->cancellation);
+            std::lock_guard lock(port->transmitMutex);
+
+            while (count > 0) {
+                const int remaining = deadline.remaining();
+                if (remaining == 0) {
+                    break;
+                }
+
+                const int result = uring.writev(port->hSerialPort, segment, static_cast<unsigned>(count), std::chrono::milliseconds(std::max(remaining, 0)), &port->uringOperations, &wait);
+
+                // Error if cancel aborted the write before any byte went out
+                if (result <= 0 && wait.cancelled()) {
+                    return bytesWritten > 0 ? bytesWritten : status(StatusCodes::CANCELLED_ERROR);
+                }
+
+                if (result == -ECANCELED || result == -ETIME || result == 0) {
+                    break;
+                }
+
+                if (result < 0) {
+                    return bytesWritten > 0 ? bytesWritten : status(StatusCodes::WRITE_ERROR);
+                }
+
+                bytesWritten += result;
+                consumeSegments(segment, count, static_cast<std::size_t>(result));
+            }
+
+            return bytesWritten;
+        }
+#endif
+
+        // The tty is non-blocking, a full output queue is waited out in poll until the deadline has passed
+        while (count > 0) {
+            const ssize_t result = ::writev(port->hSerialPort, segment, count);
+
+            if (result > 0) {
+                bytesWritten += static_cast<int>(result);
+                consumeSegments(segment, count, static_cast<std::size_t>(result));
+                continue;
+            }
+
+            if (result < 0 && errno == EINTR) {
+                continue;
+            }
+
+            if (result < 0 && errno != EAGAIN) {
+                return bytesWritten > 0 ? bytesWritten : status(StatusCodes::WRITE_ERROR);
+            }
+
+            const int remaining = deadline.remaining();
+            if (remaining == 0) {
+                break;
+            }
+
+            const int ready = pollPort(port, POLLOUT, remaining, StatusCodes::WRITE_ERROR);
+            if (ready < 0) {
+                return bytesWritten > 0 ? bytesWritten : ready;
+            }
+
+            if (ready == 0) {
+                break;
+            }
+        }
+
+        return bytesWritten;
+    }
+
+    /**
+    * @brief Returns the `Bnnn` code of a standard baudrate or `BOTHER` for any other rate.
+    */
+    static auto speedOf(const int baudrate) -> speed_t {
+        static constexpr std::pair<int, speed_t> standardRates[] = {
+            {50, B50}, {75, B75}, {110, B110}, {134, B134}, {150, B150}, {200, B200},
+            {300, B300}, {600, B600}, {1200, B1200}, {1800, B1800}, {2400, B2400},
+            {4800, B4800}, {9600, B9600}, {19200, B19200}, {38400, B38400},
+            {57600, B57600}, {115200, B115200}, {230400, B230400}, {460800, B460800},
+            {500000, B500000}, {576000, B576000}, {921600, B921600}, {1000000, B1000000},
+            {1152000, B1152000}, {1500000, B1500000}, {2000000, B2000000},
+            {2500000, B2500000}, {3000000, B3000000}, {3500000, B3500000}, {4000000, B4000000}
+        };
+
+        for (const auto &[rate, speed] : standardRates) {
+            if (rate == baudrate) {
+                return speed;
+            }
+        }
+
+        return BOTHER;
+    }
+
+    /**
+    * @fn auto open(void* port, const int baudrate, const int dataBits, const int parity, const int stopBits, const int engine, const int receiveBufferSize) -> int
+    * @brief Opens the specified connection to a serial device.
+    * @param port The port to open the serial connection to
+    * @param baudrate The baudrate for the serial connection when reading/writing
+    * @param dataBits The data bits
+    * @param parity The parity bits
+    * @param stopBits The stop bits
+    * @param engine The I/O engine that services the port (see `Engines`)
+    * @param receiveBufferSize Size of the receive ring of the buffered engine, rounded up to a power of two (64 KiB if `0`)
+    * @return Returns the current status code (negative) or the handle of the opened port
+    */
+    auto open(
+        void* port,
+        const int baudrate,
+        const int dataBits,
+        const int parity,
+        const int stopBits,
+        const int engine,
+        const int receiveBufferSize
+    ) -> int {
+        char *portName = static_cast<char*>(port);
+
+        auto newPort = std::make_shared<Port>();
+
+        switch(engine) {
+            case static_cast<int>(Engines::BLOCKING):
+                break;
+#if defined(__linux__)
+            case static_cast<int>(Engines::REACTOR):
+                break;
+            case static_cast<int>(Engines::BUFFERED):
+                break;
+            case static_cast<int>(Engines::IO_URING):
+                // Error if the kernel has no io_uring or it is disabled
+                if (!Uring::instance()) {
+                    return status(StatusCodes::NOT_SUPPORTED_ERROR);
+                }
+                break;
+#endif
+            default:
+                return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        newPort->engine = static_cast<Engines>(engine);
+        newPort->path = portName;
+
+        // Open new serial connection
+        newPort->hSerialPort = ::open(portName, O_RDWR | O_NOCTTY | O_CLOEXEC);
+
+        // Error if open fails
+        if (newPort->hSerialPort < 0) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        termios2 &tty = newPort->tty;
+
+        // Error if configuration get fails
+        if (ioctl(newPort->hSerialPort, TCGETS2, &tty) != 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        tty.c_cflag &= ~PARENB; // Clear parity bit, disabling parity (most common)
+        tty.c_cflag &= ~CSTOPB; // Clear stop field, only one stop bit used in communication (most common)
+        tty.c_cflag &= ~CSIZE;  // Clear all bits that set the data size
+        tty.c_cflag |= CS8;     // 8 bits per byte (most common)
+        tty.c_cflag &= ~CRTSCTS; // Disable RTS/CTS hardware flow control (most common)
+        tty.c_cflag |= CREAD | CLOCAL; // Turn on READ & ignore ctrl lines (CLOCAL = 1)
+
+        tty.c_lflag &= ~ICANON;
+        tty.c_lflag &= ~ECHO;   // Disable echo
+        tty.c_lflag &= ~ECHOE;  // Disable erasure
+        tty.c_lflag &= ~ECHONL; // Disable new-line echo
+        tty.c_lflag &= ~ISIG;   // Disable interpretation of INTR, QUIT and SUSP
+        tty.c_iflag &= ~(IXON | IXOFF | IXANY); // Turn off s/w flow ctrl
+        tty.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | IGNCR | ICRNL); // Disable any special handling of received bytes
+        tty.c_oflag &= ~OPOST; // Prevent special interpretation of output bytes (e.g. newline chars)
+        tty.c_oflag &= ~ONLCR; // Prevent conversion of newline to carriage return/line feed
+
+        // Every engine waits with its own deadline, the tty never stalls a read on a timer of its own.
+        // Non-blocking reads of an empty tty fail with EAGAIN and io_uring reads complete with the first byte.
+        tty.c_cc[VTIME] = 0;
+        tty.c_cc[VMIN] = 1;
+
+        // Blocking reads only follow a poll, so they take what is there and never block on their own
+        if (newPort->engine == Engines::BLOCKING) {
+            tty.c_cc[VMIN] = 0;
+        }
+
+        // Error if the baudrate is invalid
+        if (baudrate <= 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        // Standard rates keep their Bnnn code for drivers that do not know BOTHER, any other
+        // rate is passed through c_ispeed/c_ospeed and the driver picks the closest divisor
+        const speed_t speed = speedOf(baudrate);
+        tty.c_cflag &= ~(CBAUD | (CBAUD << IBSHIFT));
+        tty.c_cflag |= speed | (speed << IBSHIFT);
+        tty.c_ispeed = baudrate;
+        tty.c_ospeed = baudrate;
+
+        // Data bits
+        tty.c_cflag     &=  ~CSIZE;			// CSIZE is a mask for the number of bits per character
+        switch(dataBits) {
+            case 5:
+                tty.c_cflag     |=  CS5;
+                break;
+            case 6:
+                tty.c_cflag     |=  CS6;
+                break;
+            case 7:
+                tty.c_cflag     |=  CS7;
+                break;
+            default:
+                tty.c_cflag     |=  CS8;
+                break;
+        }
+
+        // Parity, same values as on Windows (NOPARITY, ODDPARITY, EVENPARITY, MARKPARITY, SPACEPARITY)
+        tty.c_cflag     &=  ~(PARENB | PARODD | CMSPAR);
+        switch(parity) {
+            case 0:
+                break;
+            case 1:
+                tty.c_cflag     |=  PARENB | PARODD;
+                break;
+            case 2:
+                tty.c_cflag     |=  PARENB; // Clearing PARODD makes the parity even
+                break;
+            case 3:
+                tty.c_cflag     |=  PARENB | CMSPAR | PARODD;
+                break;
+            case 4:
+                tty.c_cflag     |=  PARENB | CMSPAR;
+                break;
+            default:
+                return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        // Stop bits
+        switch(stopBits) {
+            case 0:
+                tty.c_cflag     &=  ~CSTOPB;
+                break;
+            // 1.5 stop bits are not supported by termios
+            case 2:
+                tty.c_cflag     |=  CSTOPB;
+                break;
+            default:
+                return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        // Error if configuration set fails
+        if (ioctl(newPort->hSerialPort, TCSETS2, &tty) != 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        // Read back what the driver actually applied, its rate may differ from the requested one
+        if (ioctl(newPort->hSerialPort, TCGETS2, &tty) != 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        // Blocking engine writes wait for room in poll like the others, so their deadline and cancel can end the wait
+        if (newPort->engine == Engines::BLOCKING) {
+            fcntl(newPort->hSerialPort, F_SETFL, fcntl(newPort->hSerialPort, F_GETFL) | O_NONBLOCK);
+        }
+
+#if defined(__linux__)
+        if (newPort->engine == Engines::REACTOR) {
+            // The reactor thread must never block on the tty
+            fcntl(newPort->hSerialPort, F_SETFL, fcntl(newPort->hSerialPort, F_GETFL) | O_NONBLOCK);
+
+            std::weak_ptr<Port> weakPort = newPort;
+            newPort->reactorId = Reactor::instance().add(
+                newPort->hSerialPort,
+                EPOLLIN | EPOLLRDHUP,
+                [weakPort](const std::uint32_t events) {
+                    onReadable(weakPort, events);
+                }
+            );
+
+            // Error if the tty can not be polled
+            if (newPort->reactorId == 0) {
+                return status(StatusCodes::SET_PROPERTY_ERROR);
+            }
+        }
+
+        if (newPort->engine == Engines::BUFFERED) {
+            fcntl(newPort->hSerialPort, F_SETFL, fcntl(newPort->hSerialPort, F_GETFL) | O_NONBLOCK);
+
+            newPort->readerStopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            // Error if the reader thread can not be woken up for closing
+            if (newPort->readerStopFd < 0) {
+                return status(StatusCodes::SET_PROPERTY_ERROR);
+            }
+
+            newPort->receiveRing = std::make_unique<SpscRing>(receiveBufferSize > 0 ? static_cast<std::size_t>(receiveBufferSize) : defaultReceiveRingSize);
+            newPort->readerThread = std::thread(bufferedReaderLoop, newPort.get());
+        }
+
+        // Ports that find the registered pool exhausted fall back to plain (unregistered) transfers
+        if (newPort->engine == Engines::IO_URING) {
+            newPort->uringReceiveBuffer = Uring::instance()->acquireBuffer();
+            newPort->uringTransmitBuffer = Uring::instance()->acquireBuffer();
+        }
+#endif
+
+        const int handle = ports.insert(std::move(newPort));
+
+        // Error if every slot of the port table is in use
+        if (handle < 0) {
+            return status(StatusCodes::PORT_LIMIT_ERROR);
+        }
+
+        return handle;
+    }
+
+    /**
+    * @fn auto close(const int handle) -> int
+    * @brief Closes the specified connection to a serial device.
+    * Calls that are waiting on the port get cancelled, the file descriptor is released as soon as no other call is using the port anymore.
+    * @param handle The handle of the port
+    * @return Returns the current status code
+    */
+    auto close(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port || !ports.remove(handle)) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        cancelWaits(port);
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto cancel(const int handle) -> int
+    * @brief Wakes every call that is waiting on the port, they return `CANCELLED_ERROR` or the bytes they received so far.
+    * Returns once none of them is waiting anymore, calls that start afterwards are not affected.
+    * Waits in the write queue and in pacing are not cancelled.
+    * @param handle The handle of the port
+    * @return Returns the current status code
+    */
+    auto cancel(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the waits of the port can not be cancelled
+        if (!cancelWaits(port)) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto read(const int handle, void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
+    * @brief Reads the specified number of bytes into the buffer.
+    * The read returns as soon as the buffer is full, after `timeout + multiplier * bufferSize` milliseconds
+    * or once no further byte arrived for `timeout` milliseconds. Without any timeout it only takes the bytes already received.
+    * **It is not guaranteed that the complete buffer will be fully read.**
+    * @param handle The handle of the port
+    * @param buffer The buffer in which the bytes should be read into
+    * @param bufferSize The size of the buffer
+    * @param timeout Timeout to cancel the read, also the longest gap between two received chunks
+    * @param multiplier Milliseconds per requested byte that are added to the timeout
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto read(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        // Error if the receive ring is consumed through its mapping
+        if (port->receiveRingMapped) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        return port->stats.read(bufferSize, [&] {
+            Deadline deadline = Deadline::forRead(timeout, multiplier, bufferSize);
+            return receive(port, buffer, bufferSize, deadline);
+        });
+    }
+
+    /**
+    * @fn auto readUntil(const int handle, void* buffer, const int bufferSize, const int timeout, const int multiplier, void* searchString) -> int
+    * @brief Reads until the specified string is found. If the specified string is not found, the buffer is read full until there are no more bytes to read.
+    * Bytes received after the string are kept for the next read.
+    * After `setCanonicalLines`, repeated single byte delimiters let the line discipline split the lines, see there for its limits.
+    * **It is not guaranteed that the complete buffer will be fully read.**
+    * @param handle The handle of the port
+    * @param buffer The buffer in which the bytes should be read into
+    * @param bufferSize The size of the buffer
+    * @param timeout Timeout to cancel the read, also the longest gap between two received chunks
+    * @param multiplier Milliseconds per requested byte that are added to the timeout
+    * @param searchString The string to search for
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto readUntil(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier,
+        void* searchString
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        // Error if the receive ring is consumed through its mapping
+        if (port->receiveRingMapped) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        return port->stats.read(bufferSize, [&] {
+            Deadline deadline = Deadline::forRead(timeout, multiplier, bufferSize);
+            return receiveUntil(port, buffer, bufferSize, deadline, static_cast<char*>(searchString));
+        });
+    }
+
+    /**
+    * @fn auto readLines(const int handle, void* buffer, const int bufferSize, void* offsets, const int maxLines, const int timeout, const int multiplier, void* untilChar) -> int
+    * @brief Reads every complete line that has been received, up to `maxLines`, in one call.
+    * Waits until the first line is complete or the deadline has passed, later lines are only taken if they already arrived.
+    * An unfinished trailing line is kept for the next read. A buffer that fills up without any delimiter is returned as a single line.
+    * @param handle The handle of the port
+    * @param buffer The buffer in which the lines should be read into
+    * @param bufferSize The size of the buffer
+    * @param offsets The `uint32` array the start and end offset of every line is written into, the end excludes the delimiter
+    * @param maxLines The number of lines the offsets array has room for, it holds `2 * maxLines` entries
+    * @param timeout Timeout to cancel the wait for the first line, also the longest gap between two received chunks
+    * @param multiplier Milliseconds per byte of the buffer that are added to the timeout
+    * @param untilChar The string that ends a line, `\n` if it is empty
+    * @return Returns the current status code (negative) or number of lines read
+    */
+    auto readLines(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        void* offsets,
+        const int maxLines,
+        const int timeout,
+        const int multiplier,
+        void* untilChar
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if there is no room for a single line
+        if (maxLines <= 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        // Error if the receive ring is consumed through its mapping
+        if (port->receiveRingMapped) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        const char *delimiter = static_cast<char*>(untilChar);
+        if (delimiter[0] == '\0') {
+            delimiter = "\n";
+        }
+
+        // The matcher is cached on the port and only rebuilt when the delimiter changes
+        port->delimiterMatcher.compile(delimiter, strlen(delimiter));
+
+        // A batch takes many lines per read, which raw mode does and canonical mode does not
+        selectLineMode(port, nullptr, bufferSize);
+
+        Deadline deadline = Deadline::forRead(timeout, multiplier, bufferSize);
+        Deadline available = Deadline::forRead(0, 0, 0);
+
+        const auto start = PortStats::Clock::now();
+        std::size_t consumed = 0;
+
+        const int lines = readLineBatch(
+            port->pushback,
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(std::max(bufferSize, 0)),
+            static_cast<std::uint32_t*>(offsets),
+            static_cast<std::size_t>(maxLines),
+            port->delimiterMatcher,
+            [&port, &deadline, &available](char* destination, const std::size_t size, const bool wait) {
+                return readSome(port, destination, static_cast<int>(size), wait ? deadline : available);
+            },
+            consumed
+        );
+
+        port->stats.recordRead(start, bufferSize, lines < 0 ? lines : static_cast<int>(consumed));
+
+        return lines;
+    }
+
+    /**
+    * @fn auto write(const int handle, void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
+    * @brief Writes the buffer to the serial device.
+    * **It is not guaranteed that the complete buffer will be fully written.**
+    * @param handle The handle of the port
+    * @param buffer The buffer in which the bytes should be read into
+    * @param bufferSize The size of the buffer
+    * @param timeout Timeout to cancel the write, no timeout if it and the multiplier are `0`
+    * @param multiplier Milliseconds per byte that are added to the timeout
+    * @return Returns the current status code (negative) or number of bytes written
+    */
+    auto write(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        return port->stats.write(bufferSize, [&] {
+            return writePaced(port, buffer, bufferSize, Deadline::forWrite(timeout, multiplier, bufferSize));
+        });
+    }
+
+    /**
+    * @fn auto readv(const int handle, void* segments, const int segmentCount, const int timeout, const int multiplier) -> int
+    * @brief Reads into several buffers at once, the segments are filled one after another.
+    * **It is not guaranteed that all segments will be fully read.**
+    * @param handle The handle of the port
+    * @param segments The `IoSegment` array of the buffers in which the bytes should be read into
+    * @param segmentCount The number of segments
+    * @param timeout Timeout to cancel the read, also the longest gap between two received chunks
+    * @param multiplier Milliseconds per requested byte that are added to the timeout
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto readv(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::vector<iovec> iovecs;
+
+        // Error if there are too many segments
+        if (!toIovecs(segments, segmentCount, iovecs)) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        // Error if the receive ring is consumed through its mapping
+        if (port->receiveRingMapped) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        return port->stats.read(segmentsSize(iovecs), [&] {
+            Deadline deadline = Deadline::forRead(timeout, multiplier, segmentsSize(iovecs));
+            return readSegments(port, iovecs, deadline);
+        });
+    }
+
+    /**
+    * @fn auto writev(const int handle, void* segments, const int segmentCount, const int timeout, const int multiplier) -> int
+    * @brief Writes several buffers at once, in the order of the segments and without joining them first.
+    * **It is not guaranteed that all segments will be fully written.**
+    * @param handle The handle of the port
+    * @param segments The `IoSegment` array of the buffers to write
+    * @param segmentCount The number of segments
+    * @param timeout Timeout to cancel the write, no timeout if it and the multiplier are `0`
+    * @param multiplier Milliseconds per byte that are added to the timeout
+    * @return Returns the current status code (negative) or number of bytes written
+    */
+    auto writev(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::vector<iovec> iovecs;
+
+        // Error if there are too many segments
+        if (!toIovecs(segments, segmentCount, iovecs)) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        return port->stats.write(segmentsSize(iovecs), [&] {
+            return writeSegments(port, iovecs, Deadline::forWrite(timeout, multiplier, segmentsSize(iovecs)));
+        });
+    }
+
+    /**
+    * @fn auto transact(const int handle, void* request, const int requestSize, void* response, const int responseSize, const int timeout, const int multiplier, void* untilChar, void* result, const int resultSize) -> int
+    * @brief Writes the request and reads the response in one call.
+    * The read side of the port is claimed before the request goes out, so no other read can take the response.
+    * The response is read until the delimiter was received, the response buffer is full or its deadline has passed.
+    * An empty delimiter only stops on the length or the timeout.
+    * @param handle The handle of the port
+    * @param request The bytes to write
+    * @param requestSize The number of bytes to write
+    * @param response The buffer in which the response should be read into
+    * @param responseSize The size of the response buffer
+    * @param timeout Timeout to cancel the write and the read, also the longest gap between two received chunks
+    * @param multiplier Milliseconds per byte of the request and of the response buffer that are added to the timeouts
+    * @param untilChar The string that ends the response
+    * @param result The buffer the `TransactResult` is written into
+    * @param resultSize The size of the result buffer
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto transact(
+        const int handle,
+        void* request,
+        const int requestSize,
+        void* response,
+        const int responseSize,
+        const int timeout,
+        const int multiplier,
+        void* untilChar,
+        void* result,
+        const int resultSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (resultSize < static_cast<int>(sizeof(TransactResult))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        // Error if the receive ring is consumed through its mapping
+        if (port->receiveRingMapped) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        TransactResult counts{0, 0};
+
+        counts.bytesWritten = port->stats.write(requestSize, [&] {
+            return writePaced(port, request, requestSize, Deadline::forWrite(timeout, multiplier, requestSize));
+        });
+
+        // Error if write fails
+        if (counts.bytesWritten < 0) {
+            return counts.bytesWritten;
+        }
+
+        counts.bytesRead = port->stats.read(responseSize, [&] {
+            Deadline deadline = Deadline::forRead(timeout, multiplier, responseSize);
+            return receiveUntil(port, response, responseSize, deadline, static_cast<char*>(untilChar));
+        });
+
+        memcpy(result, &counts, sizeof(counts));
+
+        return counts.bytesRead;
+    }
+
+    /**
+    * @fn auto configureWriteQueue(const int handle, const int capacity, const int coalesceBytes, const int coalesceDelay, const int sliceSize) -> int
+    * @brief Sets up the write queue of the port, replacing the one with the default settings that `enqueueWrite` would create.
+    * @param handle The handle of the port
+    * @param capacity The number of bulk bytes the queue holds before `enqueueWrite` has to wait
+    * @param coalesceBytes The number of queued bytes that are written right away
+    * @param coalesceDelay The time in `µs` a queued byte waits for more to write them together
+    * @param sliceSize The most bulk bytes that are written at once, an urgent frame waits behind at most two slices
+    * @return Returns the current status code
+    */
+    auto configureWriteQueue(
+        const int handle,
+        const int capacity,
+        const int coalesceBytes,
+        const int coalesceDelay,
+        const int sliceSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the settings are invalid
+        if (capacity <= 0 || coalesceBytes < 0 || coalesceDelay < 0 || sliceSize <= 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        // Error if the current queue still holds bytes
+        if (port->transmitQueue && !port->transmitQueue->idle()) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        port->transmitQueue = createTransmitQueue(
+            port.get(),
+            static_cast<std::size_t>(capacity),
+            static_cast<std::size_t>(coalesceBytes),
+            std::chrono::microseconds(coalesceDelay),
+            static_cast<std::size_t>(sliceSize)
+        );
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto enqueueWrite(const int handle, void* buffer, const int bufferSize, const int priority, const int timeout) -> int
+    * @brief Copies the buffer into the write queue of the port and returns before it is written.
+    * Either the whole buffer is queued or nothing, a full queue makes the call wait for room.
+    * Urgent frames have a ring of `TransmitQueue::urgentCapacity` bytes and go out before the queued bulk bytes.
+    * @param handle The handle of the port
+    * @param buffer The buffer to queue
+    * @param bufferSize The size of the buffer
+    * @param priority The `Priorities` of the bytes
+    * @param timeout Time to wait for room in `ms`, a negative timeout waits forever
+    * @return Returns the current status code (negative) or number of bytes queued, `0` if there was no room in time
+    */
+    auto enqueueWrite(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int priority,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is invalid
+        if (bufferSize < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        // Error if the priority is unknown
+        if (priority != static_cast<int>(Priorities::BULK) && priority != static_cast<int>(Priorities::URGENT)) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        return transmitQueueOf(port)->push(
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(bufferSize),
+            static_cast<Priorities>(priority),
+            timeout
+        );
+    }
+
+    /**
+    * @fn auto flushWriteQueue(const int handle, const int timeout) -> int
+    * @brief Waits until the write queue of the port has handed every byte to the system.
+    * @param handle The handle of the port
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever
+    * @return Returns the current status code (negative) or number of bytes that are still queued
+    */
+    auto flushWriteQueue(
+        const int handle,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        if (!queue) {
+            return 0;
+        }
+
+        return static_cast<int>(queue->flush(timeout));
+    }
+
+    /**
+    * @fn auto getWriteQueueStatus(const int handle, void* buffer, const int bufferSize) -> int
+    * @brief Writes the `WriteQueueStatus` of the port into the buffer, all zero if the port has no write queue yet.
+    * @param handle The handle of the port
+    * @param buffer The buffer the status is written into
+    * @param bufferSize The size of the buffer
+    * @return Returns the current status code
+    */
+    auto getWriteQueueStatus(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (bufferSize < static_cast<int>(sizeof(WriteQueueStatus))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        const WriteQueueStatus queueStatus = queue ? queue->snapshot() : WriteQueueStatus{};
+
+        memcpy(buffer, &queueStatus, sizeof(queueStatus));
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto setPacing(const int handle, const int budget) -> int
+    * @brief Keeps the output queue of the tty at most `budget` milliseconds of the baudrate deep.
+    * Writes and the write queue hold the rest of their bytes back until the line has sent enough, so a command written later waits at most about `budget` milliseconds.
+    * @param handle The handle of the port
+    * @param budget The time the queued output may take to send in `ms`, `0` turns pacing off
+    * @return Returns the current status code
+    */
+    auto setPacing(
+        const int handle,
+        const int budget
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the budget is invalid
+        if (budget < 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        port->pacingBudget = budget;
+
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        if (port->transmitQueue) {
+            port->transmitQueue->setBacklogLimit(backlogLimitOf(port.get()));
+        }
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto setCanonicalLines(const int handle, const int enabled) -> int
+    * @brief Lets readUntil hand the line splitting to the canonical mode of the tty, which is off by default.
+    * Once readUntil has used the same single byte delimiter a few times in a row, a read wakes up once per line instead of once per chunk.
+    * **The line discipline holds at most 4095 bytes of an unfinished line and overwrites the last of them with every further byte,
+    * so streams with longer lines or binary data without delimiters lose bytes in canonical mode.**
+    * Only the blocking and the io_uring engine use it.
+    * @param handle The handle of the port
+    * @param enabled Allows canonical mode if not `0`, `0` switches the tty back to raw mode right away
+    * @return Returns the current status code
+    */
+    auto setCanonicalLines(
+        const int handle,
+        const int enabled
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        port->canonicalLines = enabled != 0;
+        port->lineDelimiterRepeats = 0;
+
+        // Error if the tty can not go back to raw mode
+        if (!port->canonicalLines && port->canonical && !setCanonical(port, false, '\0')) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto getOutputBacklog(const int handle) -> int
+    * @brief Returns the number of bytes the tty still has to send, without the ones waiting in the write queue.
+    * @param handle The handle of the port
+    * @return Returns the current status code (negative) or number of bytes in the output queue
+    */
+    auto getOutputBacklog(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        const int bytes = outputBacklog(port.get());
+
+        // Error if the driver does not tell
+        if (bytes < 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        return bytes;
+    }
+
+    /**
+    * @fn auto drain(const int handle, const int timeout) -> int
+    * @brief Waits until every byte was sent, like `tcdrain` but with a deadline.
+    * The write queue is flushed first, then the output queue of the tty and the transmitter of the UART, if the driver reports it, have to run empty.
+    * @param handle The handle of the port
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever and `0` only checks once
+    * @return Returns the current status code (negative) or number of bytes that were not sent in time
+    */
+    auto drain(
+        const int handle,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Like flushWriteQueue, a negative timeout waits forever and `0` does not wait at all
+        const Deadline deadline = timeout < 0 ? Deadline::forWrite(0, 0, 0) : Deadline::forRead(timeout, 0, 0);
+        const int baudrate = static_cast<int>(port->tty.c_ospeed);
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        const std::size_t queued = queue ? queue->flush(deadline.remaining()) : 0;
+        const int bytes = waitForBacklog(
+            [&] {
+                return outputBacklog(port.get());
+            },
+            0,
+            baudrate,
+            queued > 0 ? Deadline::forRead(0, 0, 0) : deadline
+        );
+
+        // Error if the driver does not tell
+        if (bytes < 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        if (queued > 0 || bytes > 0) {
+            return static_cast<int>(std::min<std::size_t>(queued + static_cast<std::size_t>(bytes), INT_MAX));
+        }
+
+#if defined(TIOCSERGETLSR)
+        // The last bytes may still be in the FIFO or the shift register of the UART
+        unsigned int lineStatus = 0;
+
+        while (ioctl(port->hSerialPort, TIOCSERGETLSR, &lineStatus) == 0 && !(lineStatus & TIOCSER_TEMT)) {
+            if (deadline.expired()) {
+                return 1;
+            }
+
+            std::this_thread::sleep_for(transmitTime(1, baudrate));
+        }
+#endif
+
+        return 0;
+    }
+
+    /**
+    * @fn auto tuneLatency(const int handle, const int latencyTimer, const int lowLatency, void* sysfsRoot, void* result, const int resultSize) -> int
+    * @brief Lowers the latency timer of a USB serial adapter and sets `ASYNC_LOW_LATENCY` on the driver, meant to be called right after open.
+    * The latency timer is only ever lowered. Settings that can not be applied (e.g. without write access to sysfs) are skipped, the result tells what the device ended up with.
+    * @param handle The handle of the port
+    * @param latencyTimer The latency timer in milliseconds, `0` only reads the current one
+    * @param lowLatency Sets `ASYNC_LOW_LATENCY` if not `0`
+    * @param sysfsRoot The root of sysfs, `/sys` if it is empty
+    * @param result The buffer the `LatencyTuning` is written into
+    * @param resultSize The size of the result buffer
+    * @return Returns the current status code
+    */
+    auto tuneLatency(
+        const int handle,
+        const int latencyTimer,
+        const int lowLatency,
+        void* sysfsRoot,
+        void* result,
+        const int resultSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (resultSize < static_cast<int>(sizeof(LatencyTuning))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        LatencyTuning tuning{-1, -1, -1};
+
+#if defined(__linux__)
+        const char *root = static_cast<char*>(sysfsRoot);
+        const fs::path attribute = latencyTimerPath(root && *root ? root : "/sys", port->path);
+
+        if (!attribute.empty()) {
+            tuning.previousLatencyTimer = readLatencyTimer(attribute);
+            tuning.latencyTimer = tuning.previousLatencyTimer;
+
+            if (latencyTimer > 0 && tuning.previousLatencyTimer > latencyTimer && writeLatencyTimer(attribute, latencyTimer)) {
+                tuning.latencyTimer = readLatencyTimer(attribute);
+            }
+        }
+
+        tuning.lowLatency = lowLatency ? setLowLatency(port->hSerialPort) : -1;
+#endif
+
+        memcpy(result, &tuning, sizeof(tuning));
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto getBaudrate(const int handle) -> int
+    * @brief Reads the output baudrate the driver actually runs the port at.
+    * Custom rates are approximated by the divisor of the UART, so it may differ from the one passed to open.
+    * @param handle The handle of the port
+    * @return Returns the current status code (negative) or the baudrate
+    */
+    auto getBaudrate(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        termios2 tty{};
+
+        // Error if configuration get fails
+        if (ioctl(port->hSerialPort, TCGETS2, &tty) != 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        return static_cast<int>(tty.c_ospeed);
+    }
+
+    /**
+    * @fn auto getStats(const int handle, void* buffer, const int bufferSize) -> int
+    * @brief Copies the statistics of the port, a `PortStatistics` header followed by its histograms.
+    * The calls on the port are not held up while they are copied.
+    * @param handle The handle of the port
+    * @param buffer The buffer the statistics are written into
+    * @param bufferSize The size of the buffer
+    * @return Returns the current status code (negative) or number of bytes written
+    */
+    auto getStats(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (bufferSize < static_cast<int>(PortStats::snapshotSize)) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        port->stats.snapshot(static_cast<char*>(buffer));
+
+        return static_cast<int>(PortStats::snapshotSize);
+    }
+
+    /**
+    * @fn auto mapReceiveRing(const int handle, void* descriptor, const int descriptorSize) -> int
+    * @brief Hands out the receive ring of a buffered port, so the caller can consume it without any further call.
+    * From then on the caller is the only consumer of the ring and read/readUntil of the port fail with `BUSY_ERROR`.
+    * The ring stays valid until the port is closed.
+    * @param handle The handle of the port
+    * @param descriptor The buffer the `ReceiveRingDescriptor` is written into
+    * @param descriptorSize The size of the buffer
+    * @return Returns the current status code
+    */
+    auto mapReceiveRing(
+        const int handle,
+        void* descriptor,
+        const int descriptorSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the port has no receive ring
+        if (!port->receiveRing) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (descriptorSize < static_cast<int>(sizeof(ReceiveRingDescriptor))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        // Wait for a read that is still consuming the ring
+        std::lock_guard lock(port->readMutex);
+
+        // Bytes already taken out of the ring by readUntil would be skipped by the new consumer
+        if (!port->pushback.empty()) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        const ReceiveRingDescriptor ring{
+            reinterpret_cast<std::uint64_t>(port->receiveRing->data()),
+            static_cast<std::uint32_t>(port->receiveRing->size()),
+            static_cast<std::uint32_t>(SpscRing::headOffset),
+            static_cast<std::uint32_t>(SpscRing::tailOffset),
+            static_cast<std::uint32_t>(SpscRing::dataOffset)
+        };
+
+        memcpy(descriptor, &ring, sizeof(ring));
+        port->receiveRingMapped = true;
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto getAvailablePorts(void* buffer, const int bufferSize, void* separator) -> int
+    * @brief Get all the available serial ports.
+    * Like the `/dev/serial/by-id` scan, only USB ports are listed, on-board and PCI ttys are left out.
+    * The USB ports of the hotplug registry are listed without touching the file system, `/dev/serial/by-id` is only scanned without it.
+    * A USB port is told apart by the vendor id of its USB ancestor in sysfs rather than by the udev link, `enumeratePorts` lists every port.
+    * @param buffer The buffer in which the bytes should be read into
+    * @param bufferSize The size of the buffer
+    * @param separator The separator for the array buffer
+    * @return Returns the current status code (negative) or number of ports found
+    */
+    auto getAvailablePorts(
+        void* buffer,
+        const int bufferSize,
+        void* separator
+    ) -> int {
+        std::string result;
+
+        int portsCounter = 0;
+
+        const auto append = [&](const std::string &path) {
+            if (portsCounter > 0) {
+                result += std::string(static_cast<char*>(separator));
+            }
+            result += path;
+            portsCounter++;
+        };
+
+        bool listed = false;
+
+#if defined(__linux__)
+        if (PortRegistry *registry = PortRegistry::instance()) {
+            // udev links the USB ports into /dev/serial/by-id, the snapshot tells them apart by their vendor
+            for (const PortInfo &info : *registry->ports()) {
+                if (info.vendorId != 0) {
+                    append(info.path);
+                }
+            }
+
+            // Error if there are no ports, like the missing by-id directory without the registry
+            if (portsCounter == 0) {
+                return status(StatusCodes::NOT_FOUND_ERROR);
+            }
+
+            listed = true;
+        }
+#endif
+
+        if (!listed) {
+            fs::path p("/dev/serial/by-id");
+
+            try {
+                if (!exists(p)) {
+                    return status(StatusCodes::NOT_FOUND_ERROR);
+                }
+
+                for (auto de : fs::directory_iterator(p)) {
+                    if (is_symlink(de.symlink_status())) {
+                        fs::path symlink_points_at = read_symlink(de);
+                        append(fs::canonical(p / symlink_points_at).generic_string());
+                    }
+                }
+            } catch (const fs::filesystem_error &exeption) {
+            }
+        }
+
+        // Error if buffer size is to small
+        if (result.length() + 1 > static_cast<std::size_t>(bufferSize)) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        memcpy(buffer, result.c_str(), result.length() + 1);
+
+        return portsCounter;
+    }
+
+    /**
+    * @fn auto enumeratePorts(void* buffer, const int bufferSize, void* sysfsRoot) -> int
+    * @brief Describes every serial port of the system with a `PortInfo` record, sorted by path.
+    * As many records as fit are written into the buffer. If the return value exceeds `bufferSize / sizeof(PortInfo)`,
+    * call again with a larger buffer, a buffer size of `0` only counts the ports.
+    * The ports of `/sys` come from the hotplug registry without touching the file system, other roots are scanned.
+    * @param buffer The buffer the `PortInfo` records are written into
+    * @param bufferSize The size of the buffer
+    * @param sysfsRoot The root of sysfs, `/sys` if it is empty
+    * @return Returns the current status code (negative) or number of ports found
+    */
+    auto enumeratePorts(
+        void* buffer,
+        const int bufferSize,
+        void* sysfsRoot
+    ) -> int {
+        // Error if buffer size is negative
+        if (bufferSize < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+#if defined(__linux__)
+        const char *root = static_cast<char*>(sysfsRoot);
+        PortRegistry *registry = root && *root ? nullptr : PortRegistry::instance();
+
+        const PortRegistry::Ports found = registry
+            ? registry->ports()
+            : std::make_shared<const std::vector<PortInfo>>(describePorts(root && *root ? root : "/sys", "/dev"));
+        const std::size_t fitting = std::min(found->size(), static_cast<std::size_t>(bufferSize) / sizeof(PortInfo));
+
+        if (fitting > 0) {
+            memcpy(buffer, found->data(), fitting * sizeof(PortInfo));
+        }
+
+        return static_cast<int>(found->size());
+#else
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+#endif
+    }
+
+    /**
+    * @fn auto portsGeneration() -> int
+    * @brief Returns the generation of the port list, which changes whenever a port appears or disappears.
+    * Generations are only meant to be compared for equality.
+    * @return Returns the current status code (negative) or the generation
+    */
+    auto portsGeneration() -> int {
+#if defined(__linux__)
+        PortRegistry *registry = PortRegistry::instance();
+
+        // Error if the ports can not be watched
+        if (!registry) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        return static_cast<int>(registry->generation() & INT_MAX);
+#else
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+#endif
+    }
+
+    /**
+    * @fn auto waitPortsChanged(const int generation, const int timeout) -> int
+    * @brief Waits until a port appears or disappears, returns immediately if the list already changed since `generation`.
+    * @param generation The generation the caller last saw
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever
+    * @return Returns the current status code (negative) or the generation, which equals `generation` if the timeout expired
+    */
+    auto waitPortsChanged(
+        const int generation,
+        const int timeout
+    ) -> int {
+#if defined(__linux__)
+        PortRegistry *registry = PortRegistry::instance();
+
+        // Error if the ports can not be watched
+        if (!registry) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        std::uint64_t known = registry->generation();
+
+        // The caller only knows the lower bits of the generation
+        if (static_cast<int>(known & INT_MAX) != generation) {
+            return static_cast<int>(known & INT_MAX);
+        }
+
+        return static_cast<int>(registry->waitForChange(known, timeout) & INT_MAX);
+#else
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+#endif
     }
-    return portsCounter;
 }
 
 #endif
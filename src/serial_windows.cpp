@@ -3,103 +3,325 @@
 
 namespace WindowsSystem {
 
-    HANDLE hSerialPort;
-    DCB dcbSerialParams = {0};
-    COMMTIMEOUTS timeouts = {0};
-    std::string data;
+    PortTable<Port> ports;
+
+    Port::~Port() {
+        // The writer thread of the write queue still writes to the port
+        transmitQueue.reset();
+
+        if (hSerialPort != INVALID_HANDLE_VALUE) {
+            CloseHandle(hSerialPort);
+        }
+    }
+
+    /**
+    * @brief Changes the comm timeouts of the port and applies them to the handle.
+    * Reads and writes of the port share the timeouts of the handle, so every change goes through here.
+    * @return Returns `false` if the timeouts can not be set
+    */
+    template <typename Change>
+    static auto setTimeouts(const std::shared_ptr<Port> &port, Change change) -> bool {
+        std::lock_guard lock(port->timeoutsMutex);
+
+        change(port->timeouts);
+
+        return SetCommTimeouts(port->hSerialPort, &port->timeouts);
+    }
+
+    /**
+    * @brief Starts an overlapped read or write and waits for it, so a read and a write of the port are in flight at the same time.
+    * @return Returns `false` if the transfer fails, `GetLastError` tells why
+    */
+    static auto transfer(const std::shared_ptr<Port> &port, const bool reading, void* data, const DWORD size, DWORD &transferred) -> bool {
+        OVERLAPPED overlapped{};
+        overlapped.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+
+        if (overlapped.hEvent == NULL) {
+            return false;
+        }
+
+        const BOOL started = reading
+            ? ReadFile(port->hSerialPort, data, size, NULL, &overlapped)
+            : WriteFile(port->hSerialPort, data, size, NULL, &overlapped);
+
+        transferred = 0;
+        BOOL done = FALSE;
+
+        if (started || GetLastError() == ERROR_IO_PENDING) {
+            done = GetOverlappedResult(port->hSerialPort, &overlapped, &transferred, TRUE);
+        }
+
+        const DWORD error = GetLastError();
+        CloseHandle(overlapped.hEvent);
+        SetLastError(error);
+
+        return done;
+    }
+
+    /**
+    * @brief Reads with the comm timeouts that are currently set on the port.
+    */
+    static auto readFile(const std::shared_ptr<Port> &port, void* destination, const DWORD size) -> int {
+        DWORD bytesRead;
+
+        // Error if read fails, a read that cancel aborted is told apart
+        if (!transfer(port, true, destination, size, bytesRead)) {
+            return GetLastError() == ERROR_OPERATION_ABORTED ? status(StatusCodes::CANCELLED_ERROR) : status(StatusCodes::READ_ERROR);
+        }
+
+        return static_cast<int>(bytesRead);
+    }
 
     /**
-    * @fn auto open(void* port, const int baudrate, const int dataBits, const int parity, const int stopBits) -> int
+    * @brief Writes with the comm timeouts that are currently set on the port.
+    */
+    static auto writeFile(const std::shared_ptr<Port> &port, const void* data, const DWORD size) -> int {
+        DWORD bytesWritten;
+
+        // Error if write fails, a write that cancel aborted is told apart
+        if (!transfer(port, false, const_cast<void*>(data), size, bytesWritten)) {
+            return GetLastError() == ERROR_OPERATION_ABORTED ? status(StatusCodes::CANCELLED_ERROR) : status(StatusCodes::WRITE_ERROR);
+        }
+
+        return static_cast<int>(bytesWritten);
+    }
+
+    /**
+    * @brief Returns the number of bytes the driver still has to send or `-1` if it does not tell.
+    */
+    static auto outputBacklog(const Port* port) -> int {
+        DWORD errors;
+        COMSTAT comStat;
+
+        if (!ClearCommError(port->hSerialPort, &errors, &comStat)) {
+            return -1;
+        }
+
+        return static_cast<int>(comStat.cbOutQue);
+    }
+
+    /**
+    * @brief Returns the number of bytes the pacing budget of the port lets the driver hold, `0` if the port is not paced.
+    */
+    static auto backlogLimitOf(const Port* port) -> std::size_t {
+        const int budget = port->pacingBudget;
+
+        if (budget == 0) {
+            return 0;
+        }
+
+        return pacingLimit(static_cast<int>(port->dcbSerialParams.BaudRate), budget);
+    }
+
+    /**
+    * @brief Writes with the comm timeouts that are currently set on the port, in pieces that stay within the pacing budget if the port has one.
+    */
+    static auto writePaced(const std::shared_ptr<Port> &port, const void* data, const int size, const Deadline &deadline) -> int {
+        const std::size_t limit = backlogLimitOf(port.get());
+
+        if (limit == 0 || size <= 0) {
+            return writeFile(port, data, static_cast<DWORD>(size));
+        }
+
+        return pacedWrite(
+            static_cast<const char*>(data),
+            static_cast<std::size_t>(size),
+            limit,
+            static_cast<int>(port->dcbSerialParams.BaudRate),
+            [&] {
+                return outputBacklog(port.get());
+            },
+            [&](const char* piece, const std::size_t pieceSize) {
+                return writeFile(port, piece, static_cast<DWORD>(pieceSize));
+            },
+            deadline
+        );
+    }
+
+    /**
+    * @brief Creates a write queue whose writer thread writes with the comm timeouts that are currently set on the port and paces the bulk bytes by the output queue of the driver.
+    */
+    static auto createTransmitQueue(
+        Port* port,
+        const std::size_t capacity,
+        const std::size_t coalesceBytes,
+        const std::chrono::microseconds coalesceDelay,
+        const std::size_t sliceSize
+    ) -> std::shared_ptr<TransmitQueue> {
+        auto writer = [port](const char* data, const int size) -> int {
+            // The port outlives its queue, so the writer may refer to it without owning it
+            const std::shared_ptr<Port> self(std::shared_ptr<Port>(), port);
+
+            return port->stats.write(size, [&] {
+                return writeFile(self, data, static_cast<DWORD>(size));
+            });
+        };
+
+        auto pending = [port]() -> int {
+            return outputBacklog(port);
+        };
+
+        auto queue = std::make_shared<TransmitQueue>(writer, pending, capacity, coalesceBytes, coalesceDelay, sliceSize);
+        queue->setBacklogLimit(backlogLimitOf(port));
+
+        return queue;
+    }
+
+    /**
+    * @brief Returns the write queue of the port, created with the default settings on first use.
+    */
+    static auto transmitQueueOf(const std::shared_ptr<Port> &port) -> std::shared_ptr<TransmitQueue> {
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        if (!port->transmitQueue) {
+            port->transmitQueue = createTransmitQueue(
+                port.get(),
+                TransmitQueue::defaultCapacity,
+                TransmitQueue::defaultCoalesceBytes,
+                TransmitQueue::defaultCoalesceDelay,
+                TransmitQueue::defaultSliceSize
+            );
+        }
+
+        return port->transmitQueue;
+    }
+
+    /**
+    * @fn auto open(void* port, const int baudrate, const int dataBits, const int parity, const int stopBits, const int engine, const int receiveBufferSize) -> int
     * @brief Opens the specified connection to a serial device.
     * @param port The port to open the serial connection to
     * @param baudrate The baudrate for the serial connection when reading/writing
     * @param dataBits The data bits
     * @param parity The parity bits
     * @param stopBits The stop bits
-    * @return Returns the current status code
+    * @param engine The I/O engine, only the blocking engine is available on Windows
+    * @param receiveBufferSize Size of the receive ring of the buffered engine, unused on Windows
+    * @return Returns the current status code (negative) or the handle of the opened port
     */
     auto open(
         void* port,
         const int baudrate,
         const int dataBits,
         const int parity,
-        const int stopBits
+        const int stopBits,
+        const int engine,
+        const int receiveBufferSize
     ) -> int {
 
+        // Error if the engine is not available on Windows
+        if (engine != static_cast<int>(Engines::BLOCKING)) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
         char *portName = static_cast<char*>(port);
 
-        dcbSerialParams.DCBlength = sizeof(DCB);
+        auto newPort = std::make_shared<Port>();
 
-        hSerialPort = CreateFile(
+        newPort->dcbSerialParams.DCBlength = sizeof(DCB);
+
+        newPort->hSerialPort = CreateFile(
             portName,
             GENERIC_READ | GENERIC_WRITE,
             0,
             NULL,
             OPEN_EXISTING,
-            FILE_ATTRIBUTE_NORMAL,
+            FILE_FLAG_OVERLAPPED, // Synchronous handles serialize every read and write, overlapped ones let both run at once
             NULL
         );
 
         // Error if open fails
-        if (hSerialPort == INVALID_HANDLE_VALUE) {
+        if (newPort->hSerialPort == INVALID_HANDLE_VALUE) {
             return status(StatusCodes::INVALID_HANDLE_ERROR);
         }
 
         // Error if configuration get fails
-        if (!GetCommState(hSerialPort, &dcbSerialParams)) {
-            CloseHandle(hSerialPort);
+        if (!GetCommState(newPort->hSerialPort, &newPort->dcbSerialParams)) {
             return status(StatusCodes::GET_PROPERTY_ERROR);
         }
 
-        dcbSerialParams.BaudRate = baudrate;
-        dcbSerialParams.ByteSize = dataBits;
-        dcbSerialParams.Parity = static_cast<BYTE>(parity);
-        dcbSerialParams.StopBits = static_cast<BYTE>(stopBits);
+        newPort->dcbSerialParams.BaudRate = baudrate;
+        newPort->dcbSerialParams.ByteSize = dataBits;
+        newPort->dcbSerialParams.Parity = static_cast<BYTE>(parity);
+        newPort->dcbSerialParams.StopBits = static_cast<BYTE>(stopBits);
 
         // Error if configuration set fails
-        if (!SetCommState(hSerialPort, &dcbSerialParams)) {
-            CloseHandle(hSerialPort);
+        if (!SetCommState(newPort->hSerialPort, &newPort->dcbSerialParams)) {
             return status(StatusCodes::SET_PROPERTY_ERROR);
         }
-        
-        timeouts.ReadIntervalTimeout = 50;
-        timeouts.ReadTotalTimeoutConstant = 50;
-        timeouts.ReadTotalTimeoutMultiplier = 10;
-        timeouts.WriteTotalTimeoutConstant = 50;
-        timeouts.WriteTotalTimeoutMultiplier = 10;
+
+        newPort->timeouts.ReadIntervalTimeout = 50;
+        newPort->timeouts.ReadTotalTimeoutConstant = 50;
+        newPort->timeouts.ReadTotalTimeoutMultiplier = 10;
+        newPort->timeouts.WriteTotalTimeoutConstant = 50;
+        newPort->timeouts.WriteTotalTimeoutMultiplier = 10;
 
         // Error if timeout set fails
-        if (!SetCommTimeouts(hSerialPort, &timeouts)) {
-            CloseHandle(hSerialPort);
+        if (!SetCommTimeouts(newPort->hSerialPort, &newPort->timeouts)) {
             return status(StatusCodes::SET_TIMEOUT_ERROR);
         }
 
-        return status(StatusCodes::SUCCESS);
+        const int handle = ports.insert(std::move(newPort));
+
+        // Error if every slot of the port table is in use
+        if (handle < 0) {
+            return status(StatusCodes::PORT_LIMIT_ERROR);
+        }
+
+        return handle;
     }
 
     /**
-    * @fn auto close() -> int
+    * @fn auto close(const int handle) -> int
     * @brief Closes the specified connection to a serial device.
+    * Reads and writes in progress on the port get aborted, the handle is released as soon as no other call is using the port anymore.
+    * @param handle The handle of the port
     * @return Returns the current status code
     */
-    auto close() -> int {
+    auto close(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
         // Error if handle is invalid
-        if (hSerialPort == INVALID_HANDLE_VALUE) {
+        if (!port || !ports.remove(handle)) {
             return status(StatusCodes::INVALID_HANDLE_ERROR);
         }
 
-        // Error if close fails
-        if (!CloseHandle(hSerialPort)) {
-            return status(StatusCodes::CLOSE_HANDLE_ERROR);
+        CancelIoEx(port->hSerialPort, NULL);
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto cancel(const int handle) -> int
+    * @brief Aborts every read and write that is in progress on the port, they return `CANCELLED_ERROR` or the bytes they transferred so far.
+    * Calls that start afterwards are not affected.
+    * @param handle The handle of the port
+    * @return Returns the current status code
+    */
+    auto cancel(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Nothing in progress is fine as well
+        if (!CancelIoEx(port->hSerialPort, NULL) && GetLastError() != ERROR_NOT_FOUND) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
         }
 
         return status(StatusCodes::SUCCESS);
     }
 
     /**
-    * @fn auto read(void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
+    * @fn auto read(const int handle, void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
     * @brief Reads the specified number of bytes into the buffer.
     * **It is not guaranteed that the complete buffer will be fully read.**
+    * @param handle The handle of the port
     * @param buffer The buffer in which the bytes should be read into
     * @param bufferSize The size of the buffer
     * @param timeout Timeout to cancel the read
@@ -107,39 +329,60 @@ namespace WindowsSystem {
     * @return Returns the current status code (negative) or number of bytes read
     */
     auto read(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier
     ) -> int {
+        auto port = ports.find(handle);
+
         // Error if handle is invalid
-        if (hSerialPort == INVALID_HANDLE_VALUE) {
+        if (!port) {
             return status(StatusCodes::INVALID_HANDLE_ERROR);
         }
 
-        timeouts.ReadIntervalTimeout = timeout;
-        timeouts.ReadTotalTimeoutConstant = timeout;
-        timeouts.ReadTotalTimeoutMultiplier = multiplier;
+        std::lock_guard lock(port->readMutex);
+
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.ReadIntervalTimeout = timeout;
+            timeouts.ReadTotalTimeoutConstant = timeout;
+            timeouts.ReadTotalTimeoutMultiplier = multiplier;
+        });
 
         // Error if timeout set fails
-        if (!SetCommTimeouts(hSerialPort, &timeouts)) {
+        if (!timeoutsSet) {
             return status(StatusCodes::SET_TIMEOUT_ERROR);
         }
 
-        DWORD bytesRead;
+        return port->stats.read(bufferSize, [&] {
+            char *destination = static_cast<char*>(buffer);
+            const int size = std::max(bufferSize, 0);
 
-        // Error if read fails
-        if (!ReadFile(hSerialPort, buffer, bufferSize, &bytesRead, NULL)) {
-            return status(StatusCodes::READ_ERROR);
-        }
-        
-        return bytesRead;
+            // Bytes read ahead by a previous readUntil come first, the rest of the buffer is read from the device
+            const int filled = static_cast<int>(port->pushback.take(destination, static_cast<std::size_t>(size)));
+
+            if (filled == size) {
+                return filled;
+            }
+
+            const int bytesRead = readFile(port, destination + filled, static_cast<DWORD>(size - filled));
+
+            // Error if read fails, the bytes taken from the pushback are handed out first
+            if (bytesRead < 0) {
+                return filled > 0 ? filled : bytesRead;
+            }
+
+            return filled + bytesRead;
+        });
     }
 
     /**
-    * @fn auto readUntil(void* buffer, const int bufferSize, const int timeout, const int mutilplier, void* searchString) -> int
+    * @fn auto readUntil(const int handle, void* buffer, const int bufferSize, const int timeout, const int mutilplier, void* searchString) -> int
     * @brief Reads until the specified string is found. If the specified string is not found, the buffer is read full until there are no more bytes to read.
+    * Bytes received after the string are kept for the next read.
     * **It is not guaranteed that the complete buffer will be fully read.**
+    * @param handle The handle of the port
     * @param buffer The buffer in which the bytes should be read into
     * @param bufferSize The size of the buffer
     * @param timeout Timeout to cancel the read
@@ -148,53 +391,152 @@ namespace WindowsSystem {
     * @return Returns the current status code (negative) or number of bytes read
     */
     auto readUntil(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier,
         void* searchString
     ) -> int {
+        auto port = ports.find(handle);
 
-        if (hSerialPort == INVALID_HANDLE_VALUE) {
+        // Error if handle is invalid
+        if (!port) {
             return status(StatusCodes::INVALID_HANDLE_ERROR);
         }
 
-        timeouts.ReadIntervalTimeout = timeout;
-        timeouts.ReadTotalTimeoutConstant = timeout;
-        timeouts.ReadTotalTimeoutMultiplier = multiplier;
+        std::lock_guard lock(port->readMutex);
+
+        // Return as soon as any bytes are available, otherwise wait for the first byte as long as a single byte read did before
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.ReadIntervalTimeout = MAXDWORD;
+            timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+            timeouts.ReadTotalTimeoutConstant = std::max(timeout + multiplier, 1);
+        });
 
         // Error if timeout set fails
-        if (!SetCommTimeouts(hSerialPort, &timeouts)) {
+        if (!timeoutsSet) {
             return status(StatusCodes::SET_TIMEOUT_ERROR);
         }
 
-        data = "";
+        const char *delimiter = static_cast<char*>(searchString);
 
-        for (int i{0}; i < bufferSize && data.find(std::string(static_cast<char*>(searchString))) == std::string::npos; i++) {
-            DWORD bytesRead;
-            char bufferChar[1];
+        // The matcher is cached on the port and only rebuilt when the delimiter changes
+        port->delimiterMatcher.compile(delimiter, strlen(delimiter));
 
-            // Error if read fails
-            if (!ReadFile(hSerialPort, bufferChar, sizeof(bufferChar), &bytesRead, NULL)) {
-                return status(StatusCodes::READ_ERROR);
-            }
+        return port->stats.read(bufferSize, [&] {
+            return readUntilDelimiter(
+                port->pushback,
+                static_cast<char*>(buffer),
+                static_cast<std::size_t>(std::max(bufferSize, 0)),
+                port->delimiterMatcher,
+                [&port](char* destination, const std::size_t size) {
+                    return readFile(port, destination, static_cast<DWORD>(size));
+                }
+            );
+        });
+    }
 
-            if (bytesRead == 0) {
-                break;
-            }
+    /**
+    * @fn auto readLines(const int handle, void* buffer, const int bufferSize, void* offsets, const int maxLines, const int timeout, const int multiplier, void* untilChar) -> int
+    * @brief Reads every complete line that has been received, up to `maxLines`, in one call.
+    * Waits until the first line is complete or no byte arrives within the timeout, later lines are only taken if they already arrived.
+    * An unfinished trailing line is kept for the next read. A buffer that fills up without any delimiter is returned as a single line.
+    * @param handle The handle of the port
+    * @param buffer The buffer in which the lines should be read into
+    * @param bufferSize The size of the buffer
+    * @param offsets The `uint32` array the start and end offset of every line is written into, the end excludes the delimiter
+    * @param maxLines The number of lines the offsets array has room for, it holds `2 * maxLines` entries
+    * @param timeout Timeout to cancel the wait for the first line
+    * @param multiplier The time multiplier between reading
+    * @param untilChar The string that ends a line, `\n` if it is empty
+    * @return Returns the current status code (negative) or number of lines read
+    */
+    auto readLines(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        void* offsets,
+        const int maxLines,
+        const int timeout,
+        const int multiplier,
+        void* untilChar
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
 
-            data.append(std::string(bufferChar, bytesRead));
+        // Error if there is no room for a single line
+        if (maxLines <= 0) {
+            return status(StatusCodes::BUFFER_ERROR);
         }
 
-        memcpy(buffer, data.c_str(), data.length() + 1);
+        std::lock_guard lock(port->readMutex);
 
-        return data.length();
+        // Return as soon as any bytes are available, otherwise wait for the first byte like readUntil
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.ReadIntervalTimeout = MAXDWORD;
+            timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+            timeouts.ReadTotalTimeoutConstant = std::max(timeout + multiplier, 1);
+        });
+
+        // Error if timeout set fails
+        if (!timeoutsSet) {
+            return status(StatusCodes::SET_TIMEOUT_ERROR);
+        }
+
+        const char *delimiter = static_cast<char*>(untilChar);
+        if (delimiter[0] == '\0') {
+            delimiter = "\n";
+        }
+
+        // The matcher is cached on the port and only rebuilt when the delimiter changes
+        port->delimiterMatcher.compile(delimiter, strlen(delimiter));
+
+        const auto start = PortStats::Clock::now();
+        std::size_t consumed = 0;
+        bool waiting = true;
+
+        const int lines = readLineBatch(
+            port->pushback,
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(std::max(bufferSize, 0)),
+            static_cast<std::uint32_t*>(offsets),
+            static_cast<std::size_t>(maxLines),
+            port->delimiterMatcher,
+            [&port, &waiting](char* destination, const std::size_t size, const bool wait) {
+                // Once a line is complete, reads only take what the driver already holds
+                if (waiting && !wait) {
+                    waiting = false;
+
+                    const bool timeoutsSet = setTimeouts(port, [](COMMTIMEOUTS &timeouts) {
+                        timeouts.ReadTotalTimeoutMultiplier = 0;
+                        timeouts.ReadTotalTimeoutConstant = 0;
+                    });
+
+                    if (!timeoutsSet) {
+                        return 0;
+                    }
+                }
+
+                return readFile(port, destination, static_cast<DWORD>(size));
+            },
+            consumed
+        );
+
+        port->stats.recordRead(start, bufferSize, lines < 0 ? lines : static_cast<int>(consumed));
+
+        return lines;
     }
 
     /**
-    * @fn auto write(void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
+    * @fn auto write(const int handle, void* buffer, const int bufferSize, const int timeout, const int multiplier) -> int
     * @brief Writes the buffer to the serial device.
     * **It is not guaranteed that the complete buffer will be fully written.**
+    * @param handle The handle of the port
     * @param buffer The buffer in which the bytes should be read into
     * @param bufferSize The size of the buffer
     * @param timeout Timeout to cancel the read
@@ -202,27 +544,653 @@ namespace WindowsSystem {
     * @return Returns the current status code (negative) or number of bytes written
     */
     auto write(
+        const int handle,
         void* buffer,
         const int bufferSize,
         const int timeout,
         const int multiplier
     ) -> int {
-        DWORD bytesWritten;
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
 
-        timeouts.WriteTotalTimeoutConstant = timeout;
-        timeouts.WriteTotalTimeoutMultiplier = multiplier;
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.WriteTotalTimeoutConstant = timeout;
+            timeouts.WriteTotalTimeoutMultiplier = multiplier;
+        });
 
         // Error if timeout set fails
-        if (!SetCommTimeouts(hSerialPort, &timeouts)) {
+        if (!timeoutsSet) {
             return status(StatusCodes::SET_TIMEOUT_ERROR);
         }
 
+        return port->stats.write(bufferSize, [&] {
+            return writePaced(port, buffer, bufferSize, Deadline::forWrite(timeout, multiplier, bufferSize));
+        });
+    }
+
+    /**
+    * @fn auto readv(const int handle, void* segments, const int segmentCount, const int timeout, const int multiplier) -> int
+    * @brief Reads into several buffers at once, the segments are filled one after another.
+    * Every segment is a `ReadFile` of its own, the next one is only read if the previous one got filled.
+    * **It is not guaranteed that all segments will be fully read.**
+    * @param handle The handle of the port
+    * @param segments The `IoSegment` array of the buffers in which the bytes should be read into
+    * @param segmentCount The number of segments
+    * @param timeout Timeout to cancel the read
+    * @param multiplier The time multiplier between reading
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto readv(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the segment count is invalid
+        if (segmentCount < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        const IoSegment *segment = static_cast<IoSegment*>(segments);
+
+        std::lock_guard lock(port->readMutex);
+
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.ReadIntervalTimeout = timeout;
+            timeouts.ReadTotalTimeoutConstant = timeout;
+            timeouts.ReadTotalTimeoutMultiplier = multiplier;
+        });
+
+        // Error if timeout set fails
+        if (!timeoutsSet) {
+            return status(StatusCodes::SET_TIMEOUT_ERROR);
+        }
+
+        std::uint64_t size = 0;
+        for (int i = 0; i < segmentCount; i++) {
+            size += segment[i].length;
+        }
+
+        return port->stats.read(static_cast<int>(std::min<std::uint64_t>(size, INT_MAX)), [&] {
+            int bytesRead = 0;
+
+            for (int i = 0; i < segmentCount; i++) {
+                char *destination = reinterpret_cast<char*>(segment[i].address);
+
+                // Bytes read ahead by a previous readUntil come first, the rest of the segment is read from the device
+                const std::size_t taken = port->pushback.take(destination, segment[i].length);
+                bytesRead += static_cast<int>(taken);
+
+                if (taken == segment[i].length) {
+                    continue;
+                }
+
+                const int result = readFile(port, destination + taken, static_cast<DWORD>(segment[i].length - taken));
+
+                // Error if read fails
+                if (result < 0) {
+                    return bytesRead > 0 ? bytesRead : result;
+                }
+
+                bytesRead += result;
+
+                if (static_cast<std::uint64_t>(result) < segment[i].length - taken) {
+                    break;
+                }
+            }
+
+            return bytesRead;
+        });
+    }
+
+    /**
+    * @fn auto writev(const int handle, void* segments, const int segmentCount, const int timeout, const int multiplier) -> int
+    * @brief Writes several buffers at once, in the order of the segments.
+    * Serial handles do not support `WriteFileGather`, so the segments are joined natively and go out in a single `WriteFile`.
+    * **It is not guaranteed that all segments will be fully written.**
+    * @param handle The handle of the port
+    * @param segments The `IoSegment` array of the buffers to write
+    * @param segmentCount The number of segments
+    * @param timeout Timeout to cancel the write
+    * @param multiplier The time multiplier between writing
+    * @return Returns the current status code (negative) or number of bytes written
+    */
+    auto writev(
+        const int handle,
+        void* segments,
+        const int segmentCount,
+        const int timeout,
+        const int multiplier
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the segment count is invalid
+        if (segmentCount < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        const IoSegment *segment = static_cast<IoSegment*>(segments);
+
+        std::vector<char> joined;
+
+        for (int i = 0; i < segmentCount; i++) {
+            const char *data = reinterpret_cast<const char*>(segment[i].address);
+            joined.insert(joined.end(), data, data + segment[i].length);
+        }
+
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.WriteTotalTimeoutConstant = timeout;
+            timeouts.WriteTotalTimeoutMultiplier = multiplier;
+        });
+
+        // Error if timeout set fails
+        if (!timeoutsSet) {
+            return status(StatusCodes::SET_TIMEOUT_ERROR);
+        }
+
+        return port->stats.write(static_cast<int>(joined.size()), [&] {
+            return writeFile(port, joined.data(), static_cast<DWORD>(joined.size()));
+        });
+    }
+
+    /**
+    * @fn auto transact(const int handle, void* request, const int requestSize, void* response, const int responseSize, const int timeout, const int multiplier, void* untilChar, void* result, const int resultSize) -> int
+    * @brief Writes the request and reads the response in one call.
+    * The read and write timeouts are set together, so the port is reconfigured only once.
+    * The response is read until the delimiter was received, the response buffer is full or no byte arrives within the timeout.
+    * An empty delimiter only stops on the length or the timeout.
+    * @param handle The handle of the port
+    * @param request The bytes to write
+    * @param requestSize The number of bytes to write
+    * @param response The buffer in which the response should be read into
+    * @param responseSize The size of the response buffer
+    * @param timeout Timeout to cancel the write and each wait for response bytes
+    * @param multiplier The time multiplier between reading/writing
+    * @param untilChar The string that ends the response
+    * @param result The buffer the `TransactResult` is written into
+    * @param resultSize The size of the result buffer
+    * @return Returns the current status code (negative) or number of bytes read
+    */
+    auto transact(
+        const int handle,
+        void* request,
+        const int requestSize,
+        void* response,
+        const int responseSize,
+        const int timeout,
+        const int multiplier,
+        void* untilChar,
+        void* result,
+        const int resultSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (resultSize < static_cast<int>(sizeof(TransactResult))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::lock_guard lock(port->readMutex);
+
+        const bool timeoutsSet = setTimeouts(port, [&](COMMTIMEOUTS &timeouts) {
+            timeouts.ReadIntervalTimeout = MAXDWORD;
+            timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+            timeouts.ReadTotalTimeoutConstant = std::max(timeout + multiplier, 1);
+            timeouts.WriteTotalTimeoutConstant = timeout;
+            timeouts.WriteTotalTimeoutMultiplier = multiplier;
+        });
+
+        // Error if timeout set fails
+        if (!timeoutsSet) {
+            return status(StatusCodes::SET_TIMEOUT_ERROR);
+        }
+
+        const int bytesWritten = port->stats.write(requestSize, [&] {
+            return writePaced(port, request, requestSize, Deadline::forWrite(timeout, multiplier, requestSize));
+        });
+
         // Error if write fails
-        if (!WriteFile(hSerialPort, buffer, bufferSize, &bytesWritten, NULL)) {
-            return status(StatusCodes::WRITE_ERROR);
+        if (bytesWritten < 0) {
+            return bytesWritten;
         }
-        
-        return bytesWritten;
+
+        const char *delimiter = static_cast<char*>(untilChar);
+
+        port->delimiterMatcher.compile(delimiter, strlen(delimiter));
+
+        const int bytesRead = port->stats.read(responseSize, [&] {
+            return readUntilDelimiter(
+                port->pushback,
+                static_cast<char*>(response),
+                static_cast<std::size_t>(std::max(responseSize, 0)),
+                port->delimiterMatcher,
+                [&port](char* destination, const std::size_t size) {
+                    return readFile(port, destination, static_cast<DWORD>(size));
+                }
+            );
+        });
+
+        const TransactResult counts{bytesWritten, bytesRead};
+
+        memcpy(result, &counts, sizeof(counts));
+
+        return bytesRead;
+    }
+
+    /**
+    * @fn auto configureWriteQueue(const int handle, const int capacity, const int coalesceBytes, const int coalesceDelay, const int sliceSize) -> int
+    * @brief Sets up the write queue of the port, replacing the one with the default settings that `enqueueWrite` would create.
+    * @param handle The handle of the port
+    * @param capacity The number of bulk bytes the queue holds before `enqueueWrite` has to wait
+    * @param coalesceBytes The number of queued bytes that are written right away
+    * @param coalesceDelay The time in `µs` a queued byte waits for more to write them together
+    * @param sliceSize The most bulk bytes that are written at once, an urgent frame waits behind at most two slices
+    * @return Returns the current status code
+    */
+    auto configureWriteQueue(
+        const int handle,
+        const int capacity,
+        const int coalesceBytes,
+        const int coalesceDelay,
+        const int sliceSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the settings are invalid
+        if (capacity <= 0 || coalesceBytes < 0 || coalesceDelay < 0 || sliceSize <= 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        // Error if the current queue still holds bytes
+        if (port->transmitQueue && !port->transmitQueue->idle()) {
+            return status(StatusCodes::BUSY_ERROR);
+        }
+
+        port->transmitQueue = createTransmitQueue(
+            port.get(),
+            static_cast<std::size_t>(capacity),
+            static_cast<std::size_t>(coalesceBytes),
+            std::chrono::microseconds(coalesceDelay),
+            static_cast<std::size_t>(sliceSize)
+        );
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto enqueueWrite(const int handle, void* buffer, const int bufferSize, const int priority, const int timeout) -> int
+    * @brief Copies the buffer into the write queue of the port and returns before it is written.
+    * Either the whole buffer is queued or nothing, a full queue makes the call wait for room.
+    * Urgent frames have a ring of `TransmitQueue::urgentCapacity` bytes and go out before the queued bulk bytes.
+    * @param handle The handle of the port
+    * @param buffer The buffer to queue
+    * @param bufferSize The size of the buffer
+    * @param priority The `Priorities` of the bytes
+    * @param timeout Time to wait for room in `ms`, a negative timeout waits forever
+    * @return Returns the current status code (negative) or number of bytes queued, `0` if there was no room in time
+    */
+    auto enqueueWrite(
+        const int handle,
+        void* buffer,
+        const int bufferSize,
+        const int priority,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is invalid
+        if (bufferSize < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        // Error if the priority is unknown
+        if (priority != static_cast<int>(Priorities::BULK) && priority != static_cast<int>(Priorities::URGENT)) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        return transmitQueueOf(port)->push(
+            static_cast<char*>(buffer),
+            static_cast<std::size_t>(bufferSize),
+            static_cast<Priorities>(priority),
+            timeout
+        );
+    }
+
+    /**
+    * @fn auto flushWriteQueue(const int handle, const int timeout) -> int
+    * @brief Waits until the write queue of the port has handed every byte to the system.
+    * @param handle The handle of the port
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever
+    * @return Returns the current status code (negative) or number of bytes that are still queued
+    */
+    auto flushWriteQueue(
+        const int handle,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        if (!queue) {
+            return 0;
+        }
+
+        return static_cast<int>(queue->flush(timeout));
+    }
+
+    /**
+    * @fn auto getWriteQueueStatus(const int handle, void* buffer, const int bufferSize) -> int
+    * @brief Writes the `WriteQueueStatus` of the port into the buffer, all zero if the port has no write queue yet.
+    * @param handle The handle of the port
+    * @param buffer The buffer the status is written into
+    * @param bufferSize The size of the buffer
+    * @return Returns the current status code
+    */
+    auto getWriteQueueStatus(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (bufferSize < static_cast<int>(sizeof(WriteQueueStatus))) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        const WriteQueueStatus queueStatus = queue ? queue->snapshot() : WriteQueueStatus{};
+
+        memcpy(buffer, &queueStatus, sizeof(queueStatus));
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto setPacing(const int handle, const int budget) -> int
+    * @brief Keeps the output queue of the driver at most `budget` milliseconds of the baudrate deep.
+    * Writes and the write queue hold the rest of their bytes back until the line has sent enough, so a command written later waits at most about `budget` milliseconds.
+    * @param handle The handle of the port
+    * @param budget The time the queued output may take to send in `ms`, `0` turns pacing off
+    * @return Returns the current status code
+    */
+    auto setPacing(
+        const int handle,
+        const int budget
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if the budget is invalid
+        if (budget < 0) {
+            return status(StatusCodes::SET_PROPERTY_ERROR);
+        }
+
+        port->pacingBudget = budget;
+
+        std::lock_guard lock(port->transmitQueueMutex);
+
+        if (port->transmitQueue) {
+            port->transmitQueue->setBacklogLimit(backlogLimitOf(port.get()));
+        }
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto setCanonicalLines(const int handle, const int enabled) -> int
+    * @brief Windows has no canonical mode, readUntil always splits the lines itself.
+    * @param handle The handle of the port
+    * @param enabled Only `0` is supported
+    * @return Returns the current status code
+    */
+    auto setCanonicalLines(
+        const int handle,
+        const int enabled
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if canonical mode is asked for
+        if (enabled != 0) {
+            return status(StatusCodes::NOT_SUPPORTED_ERROR);
+        }
+
+        return status(StatusCodes::SUCCESS);
+    }
+
+    /**
+    * @fn auto getOutputBacklog(const int handle) -> int
+    * @brief Returns the number of bytes the driver still has to send, without the ones waiting in the write queue.
+    * @param handle The handle of the port
+    * @return Returns the current status code (negative) or number of bytes in the output queue
+    */
+    auto getOutputBacklog(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        const int bytes = outputBacklog(port.get());
+
+        // Error if the driver does not tell
+        if (bytes < 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        return bytes;
+    }
+
+    /**
+    * @fn auto drain(const int handle, const int timeout) -> int
+    * @brief Waits until every byte was sent, like `tcdrain` but with a deadline.
+    * The write queue is flushed first, then the output queue of the driver has to run empty.
+    * @param handle The handle of the port
+    * @param timeout Time to wait in `ms`, a negative timeout waits forever and `0` only checks once
+    * @return Returns the current status code (negative) or number of bytes that were not sent in time
+    */
+    auto drain(
+        const int handle,
+        const int timeout
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Like flushWriteQueue, a negative timeout waits forever and `0` does not wait at all
+        const Deadline deadline = timeout < 0 ? Deadline::forWrite(0, 0, 0) : Deadline::forRead(timeout, 0, 0);
+        const int baudrate = static_cast<int>(port->dcbSerialParams.BaudRate);
+
+        std::shared_ptr<TransmitQueue> queue;
+
+        {
+            std::lock_guard lock(port->transmitQueueMutex);
+            queue = port->transmitQueue;
+        }
+
+        const std::size_t queued = queue ? queue->flush(deadline.remaining()) : 0;
+        const int bytes = waitForBacklog(
+            [&] {
+                return outputBacklog(port.get());
+            },
+            0,
+            baudrate,
+            queued > 0 ? Deadline::forRead(0, 0, 0) : deadline
+        );
+
+        // Error if the driver does not tell
+        if (bytes < 0) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        return static_cast<int>(std::min<std::size_t>(queued + static_cast<std::size_t>(bytes), INT_MAX));
+    }
+
+    /**
+    * @fn auto tuneLatency(const int handle, const int latencyTimer, const int lowLatency, void* sysfsRoot, void* result, const int resultSize) -> int
+    * @brief Tunes the latency timer of a USB serial adapter, the drivers on Windows keep it in the registry instead.
+    * @return Returns the current status code
+    */
+    auto tuneLatency(
+        const int handle,
+        const int latencyTimer,
+        const int lowLatency,
+        void* sysfsRoot,
+        void* result,
+        const int resultSize
+    ) -> int {
+        // Error if handle is invalid
+        if (!ports.find(handle)) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+    }
+
+    /**
+    * @fn auto getBaudrate(const int handle) -> int
+    * @brief Reads the baudrate the driver actually runs the port at.
+    * @param handle The handle of the port
+    * @return Returns the current status code (negative) or the baudrate
+    */
+    auto getBaudrate(
+        const int handle
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        DCB dcb{0};
+        dcb.DCBlength = sizeof(DCB);
+
+        // Error if configuration get fails
+        if (!GetCommState(port->hSerialPort, &dcb)) {
+            return status(StatusCodes::GET_PROPERTY_ERROR);
+        }
+
+        return static_cast<int>(dcb.BaudRate);
+    }
+
+    /**
+    * @fn auto getStats(const int handle, void* buffer, const int bufferSize) -> int
+    * @brief Copies the statistics of the port, a `PortStatistics` header followed by its histograms.
+    * The calls on the port are not held up while they are copied.
+    * @param handle The handle of the port
+    * @param buffer The buffer the statistics are written into
+    * @param bufferSize The size of the buffer
+    * @return Returns the current status code (negative) or number of bytes written
+    */
+    auto getStats(
+        const int handle,
+        void* buffer,
+        const int bufferSize
+    ) -> int {
+        auto port = ports.find(handle);
+
+        // Error if handle is invalid
+        if (!port) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        // Error if buffer size is to small
+        if (bufferSize < static_cast<int>(PortStats::snapshotSize)) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        port->stats.snapshot(static_cast<char*>(buffer));
+
+        return static_cast<int>(PortStats::snapshotSize);
+    }
+
+    /**
+    * @fn auto mapReceiveRing(const int handle, void* descriptor, const int descriptorSize) -> int
+    * @brief Hands out the receive ring of a buffered port, there is no buffered engine on Windows.
+    * @return Returns the current status code
+    */
+    auto mapReceiveRing(
+        const int handle,
+        void* descriptor,
+        const int descriptorSize
+    ) -> int {
+        // Error if handle is invalid
+        if (!ports.find(handle)) {
+            return status(StatusCodes::INVALID_HANDLE_ERROR);
+        }
+
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
     }
 
     /**
@@ -276,6 +1244,84 @@ namespace WindowsSystem {
         
         return portsCounter;
     }
+
+    /**
+    * @fn auto enumeratePorts(void* buffer, const int bufferSize, void* sysfsRoot) -> int
+    * @brief Describes every serial port that can be opened with a `PortInfo` record, only the path is known on Windows.
+    * As many records as fit are written into the buffer. If the return value exceeds `bufferSize / sizeof(PortInfo)`,
+    * call again with a larger buffer, a buffer size of `0` only counts the ports.
+    * @param buffer The buffer the `PortInfo` records are written into
+    * @param bufferSize The size of the buffer
+    * @param sysfsRoot Unused on Windows
+    * @return Returns the current status code (negative) or number of ports found
+    */
+    auto enumeratePorts(
+        void* buffer,
+        const int bufferSize,
+        void* sysfsRoot
+    ) -> int {
+        // Error if buffer size is negative
+        if (bufferSize < 0) {
+            return status(StatusCodes::BUFFER_ERROR);
+        }
+
+        const std::size_t capacity = static_cast<std::size_t>(bufferSize) / sizeof(PortInfo);
+        PortInfo *records = static_cast<PortInfo*>(buffer);
+        int portsCounter = 0;
+
+        for (int i = 1; i <= 256; ++i) {
+            const std::string portName = "COM" + std::to_string(i);
+            HANDLE hPort = CreateFileA(
+                portName.c_str(),
+                GENERIC_READ | GENERIC_WRITE,
+                0,
+                NULL,
+                OPEN_EXISTING,
+                0,
+                NULL
+            );
+
+            if (hPort == INVALID_HANDLE_VALUE) {
+                continue;
+            }
+
+            CloseHandle(hPort);
+
+            if (static_cast<std::size_t>(portsCounter) < capacity) {
+                PortInfo info{};
+                info.interfaceNumber = -1;
+                memcpy(info.path, portName.c_str(), portName.length() + 1);
+                records[portsCounter] = info;
+            }
+
+            portsCounter++;
+        }
+
+        return portsCounter;
+    }
+
+    /**
+    * @fn auto portsGeneration() -> int
+    * @brief Hotplug events are not watched on Windows.
+    * @return Returns the current status code (negative)
+    */
+    auto portsGeneration() -> int {
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+    }
+
+    /**
+    * @fn auto waitPortsChanged(const int generation, const int timeout) -> int
+    * @brief Hotplug events are not watched on Windows.
+    * @param generation The generation the caller last saw
+    * @param timeout Time to wait in `ms`
+    * @return Returns the current status code (negative)
+    */
+    auto waitPortsChanged(
+        const int generation,
+        const int timeout
+    ) -> int {
+        return status(StatusCodes::NOT_SUPPORTED_ERROR);
+    }
 }
 
 #endif
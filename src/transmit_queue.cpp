@@ -0,0 +1,232 @@
+#include "transmit_queue.h"
+#include "status_codes.h"
+
+#include <algorithm>
+#include <cstring>
+
+// Largest chunk the writer takes out of the urgent ring for a single write
+constexpr std::size_t maxWriteSize = 16 * 1024;
+
+// How often the writer looks at the kernel output queue while it holds back the next bulk slice
+constexpr std::chrono::milliseconds pacingInterval{1};
+
+auto TransmitQueue::Ring::put(const char* source, const std::size_t count) -> void {
+    const std::size_t tail = (head + size) % data.size();
+    const std::size_t first = std::min(count, data.size() - tail);
+
+    memcpy(data.data() + tail, source, first);
+    memcpy(data.data(), source + first, count - first);
+
+    size += count;
+}
+
+auto TransmitQueue::Ring::take(char* destination, const std::size_t count) -> void {
+    const std::size_t first = std::min(count, data.size() - head);
+
+    memcpy(destination, data.data() + head, first);
+    memcpy(destination + first, data.data(), count - first);
+
+    head = (head + count) % data.size();
+    size -= count;
+}
+
+TransmitQueue::TransmitQueue(
+    Writer writer,
+    Pending pending,
+    const std::size_t capacity,
+    const std::size_t coalesceBytes,
+    const std::chrono::microseconds coalesceDelay,
+    const std::size_t sliceSize
+) :
+    writer(std::move(writer)),
+    pending(std::move(pending)),
+    coalesceBytes(coalesceBytes),
+    coalesceDelay(coalesceDelay),
+    sliceSize(std::max<std::size_t>(sliceSize, 1)),
+    bulk(capacity),
+    urgent(urgentCapacity) {
+    thread = std::thread([this] {
+        run();
+    });
+}
+
+TransmitQueue::~TransmitQueue() {
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+
+    queued.notify_all();
+    room.notify_all();
+    drained.notify_all();
+
+    thread.join();
+}
+
+auto TransmitQueue::push(const char* data, const std::size_t count, const Priorities priority, const int timeout) -> int {
+    Ring &ring = priority == Priorities::URGENT ? urgent : bulk;
+
+    // Error if the bytes could never fit
+    if (count > ring.data.size()) {
+        return status(StatusCodes::BUFFER_ERROR);
+    }
+
+    std::unique_lock lock(mutex);
+
+    auto hasRoom = [&] {
+        return ring.room() >= count || stopping;
+    };
+
+    if (timeout < 0) {
+        room.wait(lock, hasRoom);
+    } else {
+        room.wait_for(lock, std::chrono::milliseconds(timeout), hasRoom);
+    }
+
+    if (ring.room() < count || stopping) {
+        rejected++;
+        return 0;
+    }
+
+    if (ring.size == 0) {
+        ring.oldest = Clock::now();
+    }
+
+    ring.put(data, count);
+
+    bytesQueued += count;
+    urgentBytes += priority == Priorities::URGENT ? count : 0;
+    highWater = std::max<std::uint64_t>(highWater, depth());
+
+    queued.notify_one();
+
+    return static_cast<int>(count);
+}
+
+auto TransmitQueue::flush(const int timeout) -> std::size_t {
+    std::unique_lock lock(mutex);
+
+    auto isDrained = [&] {
+        return depth() == 0 || stopping;
+    };
+
+    if (timeout < 0) {
+        drained.wait(lock, isDrained);
+    } else {
+        drained.wait_for(lock, std::chrono::milliseconds(timeout), isDrained);
+    }
+
+    return depth();
+}
+
+auto TransmitQueue::setBacklogLimit(const std::size_t bytes) -> void {
+    backlogLimit = bytes;
+}
+
+auto TransmitQueue::idle() -> bool {
+    std::lock_guard lock(mutex);
+    return depth() == 0;
+}
+
+auto TransmitQueue::snapshot() -> WriteQueueStatus {
+    std::lock_guard lock(mutex);
+
+    return WriteQueueStatus{
+        bulk.data.size(),
+        depth(),
+        highWater,
+        bytesQueued,
+        bytesWritten,
+        writes,
+        rejected,
+        errors,
+        urgentBytes,
+        maxUrgentLatency
+    };
+}
+
+auto TransmitQueue::depth() const -> std::size_t {
+    return bulk.size + urgent.size + inFlight;
+}
+
+auto TransmitQueue::run() -> void {
+    std::vector<char> chunk(std::max(std::min(urgent.data.size(), maxWriteSize), sliceSize));
+    std::unique_lock lock(mutex);
+
+    while (true) {
+        queued.wait(lock, [&] {
+            return bulk.size > 0 || urgent.size > 0 || stopping;
+        });
+
+        if (urgent.size == 0) {
+            // Give a burst the chance to grow before it goes out
+            queued.wait_until(lock, bulk.oldest + coalesceDelay, [&] {
+                return bulk.size >= coalesceBytes || urgent.size > 0 || stopping;
+            });
+
+            // Hold the next slice back while the kernel still has more than one slice or the backlog limit to send
+            if (urgent.size == 0 && !stopping) {
+                const int backlog = pending();
+
+                if (backlog > static_cast<int>(std::max(sliceSize, backlogLimit.load()))) {
+                    queued.wait_for(lock, pacingInterval, [&] {
+                        return urgent.size > 0 || stopping;
+                    });
+
+                    continue;
+                }
+            }
+        }
+
+        if (stopping) {
+            return;
+        }
+
+        const bool isUrgent = urgent.size > 0;
+        Ring &source = isUrgent ? urgent : bulk;
+        const Clock::time_point enqueued = source.oldest;
+
+        const std::size_t count = std::min(source.size, isUrgent ? chunk.size() : sliceSize);
+
+        source.take(chunk.data(), count);
+        inFlight = count;
+
+        room.notify_all();
+        lock.unlock();
+
+        std::size_t written = 0;
+        std::uint64_t calls = 0;
+        bool failed = false;
+
+        while (written < count && !stopping) {
+            const int result = writer(chunk.data() + written, static_cast<int>(count - written));
+            calls++;
+
+            // The chunk is dropped, retrying a failing device would only spin
+            if (result < 0) {
+                failed = true;
+                break;
+            }
+
+            written += static_cast<std::size_t>(result);
+        }
+
+        const auto finished = Clock::now();
+
+        lock.lock();
+
+        inFlight = 0;
+        bytesWritten += written;
+        writes += calls;
+        errors += failed ? 1 : 0;
+
+        if (isUrgent) {
+            const auto latency = std::chrono::duration_cast<std::chrono::nanoseconds>(finished - enqueued).count();
+            maxUrgentLatency = std::max<std::uint64_t>(maxUrgentLatency, static_cast<std::uint64_t>(latency));
+        }
+
+        if (depth() == 0) {
+            drained.notify_all();
+        }
+    }
+}
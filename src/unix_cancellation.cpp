@@ -0,0 +1,83 @@
+#if defined(__linux__)
+#include "unix_cancellation.h"
+
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace UnixSystem {
+
+    Cancellation::Cancellation() {
+        eventFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    }
+
+    Cancellation::~Cancellation() {
+        if (eventFd >= 0) {
+            ::close(eventFd);
+        }
+    }
+
+    Cancellation::Wait::Wait(Cancellation &cancellation) : cancellation(cancellation) {
+        std::unique_lock lock(cancellation.mutex);
+
+        // The eventfd still carries the signal of a running cancel
+        cancellation.changed.wait(lock, [&] {
+            return !cancellation.cancelling;
+        });
+
+        cancellation.waits++;
+        generation = cancellation.generation;
+    }
+
+    Cancellation::Wait::~Wait() {
+        std::lock_guard lock(cancellation.mutex);
+
+        if (--cancellation.waits == 0) {
+            cancellation.changed.notify_all();
+        }
+    }
+
+    auto Cancellation::Wait::cancelled() const -> bool {
+        return cancellation.generation != generation;
+    }
+
+    auto Cancellation::fd() const -> int {
+        return eventFd;
+    }
+
+    auto Cancellation::cancel(const std::function<void()> &wake) -> bool {
+        if (eventFd < 0) {
+            return false;
+        }
+
+        {
+            std::unique_lock lock(mutex);
+
+            changed.wait(lock, [&] {
+                return !cancelling;
+            });
+
+            cancelling = true;
+            generation++;
+        }
+
+        const std::uint64_t value = 1;
+        [[maybe_unused]] const ssize_t written = ::write(eventFd, &value, sizeof(value));
+
+        wake();
+
+        std::unique_lock lock(mutex);
+
+        changed.wait(lock, [&] {
+            return waits == 0;
+        });
+
+        std::uint64_t signalled;
+        [[maybe_unused]] const ssize_t drained = ::read(eventFd, &signalled, sizeof(signalled));
+
+        cancelling = false;
+        changed.notify_all();
+
+        return true;
+    }
+}
+#endif
@@ -0,0 +1,70 @@
+#if defined(__linux__)
+#include "unix_latency.h"
+
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <fstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace UnixSystem {
+
+    auto latencyTimerPath(const fs::path &sysfsRoot, const std::string &ttyPath) -> fs::path {
+        std::error_code error;
+
+        fs::path tty = fs::canonical(ttyPath, error);
+        if (error) {
+            tty = ttyPath;
+        }
+
+        fs::path attribute = sysfsRoot / "class" / "tty" / tty.filename() / "device" / "latency_timer";
+
+        if (!fs::exists(attribute, error)) {
+            return {};
+        }
+
+        return attribute;
+    }
+
+    auto readLatencyTimer(const fs::path &attribute) -> int {
+        std::ifstream file(attribute);
+        int milliseconds = -1;
+
+        if (!(file >> milliseconds)) {
+            return -1;
+        }
+
+        return milliseconds;
+    }
+
+    auto writeLatencyTimer(const fs::path &attribute, const int milliseconds) -> bool {
+        std::ofstream file(attribute);
+
+        file << milliseconds << '\n';
+        file.flush();
+
+        return static_cast<bool>(file);
+    }
+
+    auto setLowLatency(const int fd) -> int {
+        serial_struct serial{};
+
+        // Ptys and USB CDC ACM devices without the serial ioctls end up here
+        if (ioctl(fd, TIOCGSERIAL, &serial) != 0) {
+            return -1;
+        }
+
+        if ((serial.flags & ASYNC_LOW_LATENCY) == 0) {
+            serial.flags |= ASYNC_LOW_LATENCY;
+            ioctl(fd, TIOCSSERIAL, &serial);
+
+            if (ioctl(fd, TIOCGSERIAL, &serial) != 0) {
+                return -1;
+            }
+        }
+
+        return (serial.flags & ASYNC_LOW_LATENCY) != 0 ? 1 : 0;
+    }
+}
+#endif
@@ -0,0 +1,176 @@
+#if defined(__linux__)
+#include "unix_port_registry.h"
+#include "unix_ports.h"
+
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <optional>
+
+namespace fs = std::filesystem;
+
+namespace UnixSystem {
+
+    // Events that add or remove a device node, renames count as both
+    constexpr std::uint32_t watchedEvents = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+    auto PortRegistry::instance() -> PortRegistry* {
+        static PortRegistry registry("/sys", "/dev");
+        return registry.watching() ? &registry : nullptr;
+    }
+
+    PortRegistry::PortRegistry(fs::path sysfsRoot, fs::path devRoot) :
+        sysfsRoot(std::move(sysfsRoot)),
+        devRoot(std::move(devRoot)),
+        current(std::make_shared<const std::vector<PortInfo>>()) {
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        stopFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        if (inotifyFd < 0 || stopFd < 0 || inotify_add_watch(inotifyFd, this->devRoot.c_str(), watchedEvents) < 0) {
+            return;
+        }
+
+        // The watch is in place before the first scan, so no port that appears in between gets lost
+        rescan();
+
+        thread = std::thread([this] {
+            run();
+        });
+    }
+
+    PortRegistry::~PortRegistry() {
+        if (thread.joinable()) {
+            const std::uint64_t one = 1;
+            [[maybe_unused]] const ssize_t written = ::write(stopFd, &one, sizeof(one));
+            thread.join();
+        }
+
+        if (inotifyFd >= 0) {
+            ::close(inotifyFd);
+        }
+
+        if (stopFd >= 0) {
+            ::close(stopFd);
+        }
+    }
+
+    auto PortRegistry::watching() const -> bool {
+        return thread.joinable();
+    }
+
+    auto PortRegistry::ports() -> Ports {
+        std::lock_guard lock(mutex);
+        return current;
+    }
+
+    auto PortRegistry::generation() -> std::uint64_t {
+        std::lock_guard lock(mutex);
+        return currentGeneration;
+    }
+
+    auto PortRegistry::waitForChange(const std::uint64_t known, const int timeout) -> std::uint64_t {
+        std::unique_lock lock(mutex);
+
+        auto hasChanged = [&] {
+            return currentGeneration != known;
+        };
+
+        if (timeout < 0) {
+            changed.wait(lock, hasChanged);
+        } else {
+            changed.wait_for(lock, std::chrono::milliseconds(timeout), hasChanged);
+        }
+
+        return currentGeneration;
+    }
+
+    auto PortRegistry::run() -> void {
+        pollfd descriptors[2] = {
+            {inotifyFd, POLLIN, 0},
+            {stopFd, POLLIN, 0}
+        };
+
+        alignas(inotify_event) char buffer[4096];
+
+        while (true) {
+            if (poll(descriptors, 2, -1) < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return;
+            }
+
+            if (descriptors[1].revents != 0) {
+                return;
+            }
+
+            const ssize_t length = ::read(inotifyFd, buffer, sizeof(buffer));
+
+            if (length <= 0) {
+                continue;
+            }
+
+            for (ssize_t offset = 0; offset < length; ) {
+                const inotify_event *event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+
+                // Events got dropped, only a full scan brings the list back in line
+                if (event->mask & IN_Q_OVERFLOW) {
+                    rescan();
+                    continue;
+                }
+
+                if (event->len > 0) {
+                    update(event->name, (event->mask & (IN_CREATE | IN_MOVED_TO)) != 0);
+                }
+            }
+        }
+    }
+
+    auto PortRegistry::rescan() -> void {
+        auto ports = std::make_shared<const std::vector<PortInfo>>(describePorts(sysfsRoot, devRoot));
+
+        std::lock_guard lock(mutex);
+
+        current = std::move(ports);
+        currentGeneration++;
+        changed.notify_all();
+    }
+
+    auto PortRegistry::update(const std::string &name, const bool added) -> void {
+        const std::string path = (devRoot / name).string();
+
+        // Describing the port reads sysfs, which happens before the list is locked
+        const std::optional<PortInfo> info = added ? describePort(sysfsRoot, devRoot, name) : std::nullopt;
+
+        std::lock_guard lock(mutex);
+
+        auto ports = std::make_shared<std::vector<PortInfo>>(*current);
+        auto position = std::lower_bound(ports->begin(), ports->end(), path, [](const PortInfo &port, const std::string &path) {
+            return strcmp(port.path, path.c_str()) < 0;
+        });
+        const bool listed = position != ports->end() && path == position->path;
+
+        // Nodes of anything but a serial port leave the list alone
+        if (!info && !listed) {
+            return;
+        }
+
+        if (info && listed) {
+            *position = *info;
+        } else if (info) {
+            ports->insert(position, *info);
+        } else {
+            ports->erase(position);
+        }
+
+        current = std::move(ports);
+        currentGeneration++;
+        changed.notify_all();
+    }
+}
+#endif
@@ -0,0 +1,145 @@
+#if defined(__linux__)
+#include "unix_ports.h"
+
+#include <linux/serial.h>
+#include <sys/ioctl.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace UnixSystem {
+
+    static auto readAttribute(const fs::path &attribute) -> std::string {
+        std::ifstream file(attribute);
+        std::string value;
+
+        std::getline(file, value);
+
+        return value;
+    }
+
+    static auto readHexAttribute(const fs::path &attribute, const long fallback) -> long {
+        const std::string value = readAttribute(attribute);
+
+        if (value.empty()) {
+            return fallback;
+        }
+
+        return strtol(value.c_str(), nullptr, 16);
+    }
+
+    /**
+    * @brief Copies the string into the record field, cutting it off if it does not fit.
+    */
+    template <std::size_t Size>
+    static auto copyField(char (&field)[Size], const std::string &value) -> void {
+        const std::size_t length = std::min(value.size(), Size - 1);
+
+        memcpy(field, value.data(), length);
+        field[length] = '\0';
+    }
+
+    /**
+    * @brief Checks if the driver link points into the `serial-base` bus of the serial core.
+    */
+    static auto isSerialBase(const fs::path &driver) -> bool {
+        return driver.parent_path().parent_path().filename() == "serial-base";
+    }
+
+    /**
+    * @brief Checks that a legacy UART is backed by actual hardware, any other port always is.
+    */
+    static auto isPresent(const std::string &path, const std::string &driver) -> bool {
+        if (driver != "serial8250") {
+            return true;
+        }
+
+        const int fd = ::open(path.c_str(), O_RDWR | O_NONBLOCK | O_NOCTTY | O_CLOEXEC);
+        if (fd < 0) {
+            return false;
+        }
+
+        serial_struct serial{};
+        const bool present = ioctl(fd, TIOCGSERIAL, &serial) == 0 && serial.type != PORT_UNKNOWN;
+
+        ::close(fd);
+
+        return present;
+    }
+
+    auto describePort(const fs::path &sysfsRoot, const fs::path &devRoot, const std::string &name) -> std::optional<PortInfo> {
+        std::error_code error;
+
+        const fs::path device = sysfsRoot / "class" / "tty" / name / "device";
+        fs::path driver = fs::read_symlink(device / "driver", error);
+
+        // Virtual terminals and ptys have no device, unbound devices no driver
+        if (error) {
+            return std::nullopt;
+        }
+
+        // Since Linux 6.3 the serial core puts port and controller devices between the tty and the UART driver
+        for (fs::path node = fs::canonical(device, error); !error && isSerialBase(driver); ) {
+            node = node.parent_path();
+            driver = fs::read_symlink(node / "driver", error);
+        }
+
+        const std::string path = (devRoot / name).string();
+
+        if (!isPresent(path, driver.filename().string())) {
+            return std::nullopt;
+        }
+
+        PortInfo info{};
+        info.interfaceNumber = -1;
+
+        copyField(info.path, path);
+        copyField(info.driver, driver.filename().string());
+
+        // Walk up from the device towards the root until the USB device turns up, if there is one
+        error.clear();
+        fs::path node = fs::canonical(device, error);
+
+        while (!error && node.has_relative_path()) {
+            if (info.interfaceNumber < 0 && fs::exists(node / "bInterfaceNumber", error)) {
+                info.interfaceNumber = static_cast<std::int32_t>(readHexAttribute(node / "bInterfaceNumber", -1));
+            }
+
+            if (fs::exists(node / "idVendor", error)) {
+                info.vendorId = static_cast<std::uint16_t>(readHexAttribute(node / "idVendor", 0));
+                info.productId = static_cast<std::uint16_t>(readHexAttribute(node / "idProduct", 0));
+                copyField(info.serialNumber, readAttribute(node / "serial"));
+                break;
+            }
+
+            node = node.parent_path();
+        }
+
+        return info;
+    }
+
+    auto describePorts(const fs::path &sysfsRoot, const fs::path &devRoot) -> std::vector<PortInfo> {
+        std::vector<PortInfo> result;
+        std::error_code error;
+
+        for (const fs::directory_entry &entry : fs::directory_iterator(sysfsRoot / "class" / "tty", error)) {
+            if (std::optional<PortInfo> info = describePort(sysfsRoot, devRoot, entry.path().filename().string())) {
+                result.push_back(*info);
+            }
+        }
+
+        std::sort(result.begin(), result.end(), [](const PortInfo &left, const PortInfo &right) {
+            return strcmp(left.path, right.path) < 0;
+        });
+
+        return result;
+    }
+}
+#endif
@@ -0,0 +1,183 @@
+#if defined(__linux__)
+#include "unix_reactor.h"
+
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <vector>
+
+namespace UnixSystem {
+
+    auto Reactor::instance() -> Reactor& {
+        // Never destroyed, ports that are still open at exit unregister themselves after static destruction
+        static Reactor *reactor = new Reactor();
+        return *reactor;
+    }
+
+    Reactor::Reactor() {
+        epollFd = epoll_create1(EPOLL_CLOEXEC);
+        wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+        // The wake up descriptor is the only registration with id 0
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = 0;
+        epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+
+        thread = std::thread([this] { run(); });
+    }
+
+    Reactor::~Reactor() {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        wake();
+
+        if (thread.joinable()) {
+            thread.join();
+        }
+
+        ::close(wakeFd);
+        ::close(epollFd);
+    }
+
+    auto Reactor::add(int fd, std::uint32_t events, EventCallback onEvents) -> std::uint64_t {
+        std::lock_guard lock(mutex);
+
+        const std::uint64_t id = nextId++;
+
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+
+        if (epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &event) != 0) {
+            return 0;
+        }
+
+        registrations.emplace(id, Registration{fd, std::move(onEvents)});
+
+        return id;
+    }
+
+    auto Reactor::modify(std::uint64_t id, std::uint32_t events) -> bool {
+        std::lock_guard lock(mutex);
+
+        auto registration = registrations.find(id);
+        if (registration == registrations.end()) {
+            return false;
+        }
+
+        epoll_event event{};
+        event.events = events;
+        event.data.u64 = id;
+
+        return epoll_ctl(epollFd, EPOLL_CTL_MOD, registration->second.fd, &event) == 0;
+    }
+
+    auto Reactor::remove(std::uint64_t id) -> void {
+        std::lock_guard lock(mutex);
+
+        auto registration = registrations.find(id);
+        if (registration == registrations.end()) {
+            return;
+        }
+
+        epoll_ctl(epollFd, EPOLL_CTL_DEL, registration->second.fd, nullptr);
+        registrations.erase(registration);
+    }
+
+    auto Reactor::addTimer(Clock::time_point deadline, TimerCallback onExpire) -> TimerId {
+        TimerId id;
+        bool earliest;
+
+        {
+            std::lock_guard lock(mutex);
+
+            id = TimerId{deadline, nextId++};
+            timers.emplace(id, std::move(onExpire));
+            earliest = timers.begin()->first == id;
+        }
+
+        // The reactor has to recalculate its epoll timeout if the new deadline comes first
+        if (earliest) {
+            wake();
+        }
+
+        return id;
+    }
+
+    auto Reactor::cancelTimer(const TimerId &id) -> void {
+        std::lock_guard lock(mutex);
+
+        timers.erase(id);
+    }
+
+    auto Reactor::wake() -> void {
+        const std::uint64_t value = 1;
+        [[maybe_unused]] const ssize_t result = ::write(wakeFd, &value, sizeof(value));
+    }
+
+    auto Reactor::run() -> void {
+        constexpr int maxEvents = 64;
+        epoll_event events[maxEvents];
+
+        std::vector<std::pair<EventCallback, std::uint32_t>> ready;
+        std::vector<TimerCallback> expired;
+
+        while (true) {
+            int waitTimeout = -1;
+
+            {
+                std::lock_guard lock(mutex);
+
+                if (stopping) {
+                    return;
+                }
+
+                if (!timers.empty()) {
+                    const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(timers.begin()->first.first - Clock::now());
+                    waitTimeout = static_cast<int>(std::max<std::chrono::milliseconds::rep>(remaining.count(), 0));
+                }
+            }
+
+            const int eventCount = epoll_wait(epollFd, events, maxEvents, waitTimeout);
+
+            {
+                std::lock_guard lock(mutex);
+
+                for (int i{0}; i < eventCount; i++) {
+                    if (events[i].data.u64 == 0) {
+                        std::uint64_t value;
+                        [[maybe_unused]] const ssize_t result = ::read(wakeFd, &value, sizeof(value));
+                        continue;
+                    }
+
+                    auto registration = registrations.find(events[i].data.u64);
+                    if (registration != registrations.end()) {
+                        ready.emplace_back(registration->second.onEvents, static_cast<std::uint32_t>(events[i].events));
+                    }
+                }
+
+                const auto now = Clock::now();
+                while (!timers.empty() && timers.begin()->first.first <= now) {
+                    expired.push_back(std::move(timers.begin()->second));
+                    timers.erase(timers.begin());
+                }
+            }
+
+            for (auto &[onEvents, triggered] : ready) {
+                onEvents(triggered);
+            }
+
+            for (auto &onExpire : expired) {
+                onExpire();
+            }
+
+            ready.clear();
+            expired.clear();
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,358 @@
+#if defined(__linux__)
+#include "unix_uring.h"
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+namespace UnixSystem {
+
+    // Number of submission queue entries, the completion queue gets twice as many
+    constexpr unsigned ringEntries = 256;
+
+    // Marks the completion of a linked timeout, of a cancel or of the wake up on shutdown, none of them has a waiting caller
+    constexpr std::uint64_t ignoredCompletion = 0;
+
+    static auto ioUringSetup(unsigned entries, io_uring_params *params) -> int {
+        return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+    }
+
+    static auto ioUringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) -> int {
+        return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+    }
+
+    static auto ioUringRegister(int fd, unsigned opcode, void* arg, unsigned count) -> int {
+        return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+    }
+
+    auto Uring::instance() -> Uring* {
+        // Never destroyed, like the reactor, so ports that are still open at exit can release their slots
+        static Uring *uring = [] {
+            Uring *uring = new Uring();
+
+            if (!uring->setup()) {
+                delete uring;
+                return static_cast<Uring*>(nullptr);
+            }
+
+            return uring;
+        }();
+
+        return uring;
+    }
+
+    auto Uring::setup() -> bool {
+        io_uring_params params{};
+
+        ringFd = ioUringSetup(ringEntries, &params);
+        if (ringFd < 0) {
+            return false;
+        }
+
+        submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        submissionEntriesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+        submissionRing = mmap(nullptr, submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQ_RING);
+        completionRing = mmap(nullptr, completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_CQ_RING);
+        submissionEntries = mmap(nullptr, submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ringFd, IORING_OFF_SQES);
+
+        if (submissionRing == MAP_FAILED || completionRing == MAP_FAILED || submissionEntries == MAP_FAILED) {
+            return false;
+        }
+
+        char *sq = static_cast<char*>(submissionRing);
+        submissionHead = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        submissionTail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        submissionMask = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        submissionArray = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+
+        char *cq = static_cast<char*>(completionRing);
+        completionHead = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        completionTail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        completionMask = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        completionEntries = cq + params.cq_off.cqes;
+
+        // Without registered buffers every transfer still works, it just pins the user pages each time
+        bufferMemory = std::aligned_alloc(4096, bufferCount * bufferSize);
+        if (bufferMemory) {
+            std::vector<iovec> iovecs(bufferCount);
+            for (std::size_t i{0}; i < bufferCount; i++) {
+                iovecs[i].iov_base = static_cast<char*>(bufferMemory) + i * bufferSize;
+                iovecs[i].iov_len = bufferSize;
+            }
+
+            buffersRegistered = ioUringRegister(ringFd, IORING_REGISTER_BUFFERS, iovecs.data(), bufferCount) == 0;
+        }
+
+        if (buffersRegistered) {
+            for (int i = static_cast<int>(bufferCount) - 1; i >= 0; i--) {
+                freeBuffers.push_back(i);
+            }
+        }
+
+        completionThread = std::thread([this] { reap(); });
+
+        return true;
+    }
+
+    Uring::~Uring() {
+        if (completionThread.joinable()) {
+            stopping = true;
+
+            // A no-op completion wakes the completion thread up
+            submit(IORING_OP_NOP, -1, nullptr, 0, -1, std::chrono::milliseconds(0), nullptr, nullptr);
+            completionThread.join();
+        }
+
+        if (submissionEntries && submissionEntries != MAP_FAILED) {
+            munmap(submissionEntries, submissionEntriesSize);
+        }
+        if (completionRing && completionRing != MAP_FAILED) {
+            munmap(completionRing, completionRingSize);
+        }
+        if (submissionRing && submissionRing != MAP_FAILED) {
+            munmap(submissionRing, submissionRingSize);
+        }
+        if (ringFd >= 0) {
+            ::close(ringFd);
+        }
+
+        std::free(bufferMemory);
+    }
+
+    auto Uring::acquireBuffer() -> int {
+        std::lock_guard lock(bufferMutex);
+
+        if (freeBuffers.empty()) {
+            return -1;
+        }
+
+        const int index = freeBuffers.back();
+        freeBuffers.pop_back();
+
+        return index;
+    }
+
+    auto Uring::releaseBuffer(int index) -> void {
+        if (index < 0) {
+            return;
+        }
+
+        std::lock_guard lock(bufferMutex);
+
+        freeBuffers.push_back(index);
+    }
+
+    auto Uring::buffer(int index) -> char* {
+        return static_cast<char*>(bufferMemory) + static_cast<std::size_t>(index) * bufferSize;
+    }
+
+    auto Uring::read(int fd, void* data, unsigned size, int bufferIndex, std::chrono::milliseconds timeout, Operations* operations, const Cancellation::Wait* wait) -> int {
+        return submit(bufferIndex >= 0 ? IORING_OP_READ_FIXED : IORING_OP_READ, fd, data, size, bufferIndex, timeout, operations, wait);
+    }
+
+    auto Uring::write(int fd, const void* data, unsigned size, int bufferIndex, std::chrono::milliseconds timeout, Operations* operations, const Cancellation::Wait* wait) -> int {
+        return submit(bufferIndex >= 0 ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE, fd, data, size, bufferIndex, timeout, operations, wait);
+    }
+
+    auto Uring::readv(int fd, const iovec* segments, unsigned count, std::chrono::milliseconds timeout, Operations* operations, const Cancellation::Wait* wait) -> int {
+        return submit(IORING_OP_READV, fd, segments, count, -1, timeout, operations, wait);
+    }
+
+    auto Uring::writev(int fd, const iovec* segments, unsigned count, std::chrono::milliseconds timeout, Operations* operations, const Cancellation::Wait* wait) -> int {
+        return submit(IORING_OP_WRITEV, fd, segments, count, -1, timeout, operations, wait);
+    }
+
+    auto Uring::reserve(const unsigned needed) -> unsigned {
+        const unsigned tail = *submissionTail;
+
+        // Flush the queue if there is no room left, the kernel consumes it right away
+        while (tail - std::atomic_ref(*submissionHead).load(std::memory_order_acquire) + needed > submissionMask + 1) {
+            ioUringEnter(ringFd, submissionMask + 1, 0, 0);
+        }
+
+        return tail;
+    }
+
+    auto Uring::entry(unsigned &tail) -> io_uring_sqe& {
+        const unsigned index = tail & submissionMask;
+        io_uring_sqe &entry = static_cast<io_uring_sqe*>(submissionEntries)[index];
+        memset(&entry, 0, sizeof(entry));
+        submissionArray[index] = index;
+        tail++;
+        return entry;
+    }
+
+    auto Uring::publish(const unsigned tail) -> void {
+        std::atomic_ref(*submissionTail).store(tail, std::memory_order_release);
+    }
+
+    auto Uring::enter(const unsigned tail) -> void {
+        // Whoever enters first submits every entry queued so far, so concurrent submissions of
+        // different ports share one system call and later callers find their entries consumed
+        if (static_cast<int>(std::atomic_ref(*submissionHead).load(std::memory_order_acquire) - tail) < 0) {
+            ioUringEnter(ringFd, submissionMask + 1, 0, 0);
+        }
+    }
+
+    auto Uring::submit(
+        std::uint8_t opcode,
+        int fd,
+        const void* data,
+        unsigned size,
+        int bufferIndex,
+        std::chrono::milliseconds timeout,
+        Operations* operations,
+        const Cancellation::Wait* wait
+    ) -> int {
+        Request request;
+        const std::uint64_t userData = reinterpret_cast<std::uint64_t>(&request);
+
+        // Copied by the kernel when the linked timeout is submitted
+        __kernel_timespec deadline{};
+        deadline.tv_sec = timeout.count() / 1000;
+        deadline.tv_nsec = (timeout.count() % 1000) * 1000000;
+
+        const unsigned needed = timeout.count() > 0 ? 2 : 1;
+        unsigned tail;
+
+        // The operation is queued before a cancel can look for it, and a cancel that came first keeps it from being queued
+        std::unique_lock<std::mutex> registration;
+
+        if (operations) {
+            registration = std::unique_lock(operations->mutex);
+
+            if (wait && wait->cancelled()) {
+                return -ECANCELED;
+            }
+
+            operations->inFlight.push_back(userData);
+        }
+
+        {
+            std::lock_guard lock(submitMutex);
+
+            tail = reserve(needed);
+
+            io_uring_sqe &operation = entry(tail);
+            operation.opcode = opcode;
+            operation.fd = fd;
+            operation.off = static_cast<std::uint64_t>(-1); // ttys have no position, use the current one
+            operation.addr = reinterpret_cast<std::uint64_t>(data);
+            operation.len = size;
+            operation.user_data = userData;
+
+            if (bufferIndex >= 0) {
+                operation.buf_index = static_cast<std::uint16_t>(bufferIndex);
+            }
+
+            if (needed == 2) {
+                operation.flags |= IOSQE_IO_LINK;
+
+                io_uring_sqe &linkedTimeout = entry(tail);
+                linkedTimeout.opcode = IORING_OP_LINK_TIMEOUT;
+                linkedTimeout.fd = -1;
+                linkedTimeout.addr = reinterpret_cast<std::uint64_t>(&deadline);
+                linkedTimeout.len = 1;
+                linkedTimeout.user_data = ignoredCompletion;
+            }
+
+            publish(tail);
+        }
+
+        if (registration.owns_lock()) {
+            registration.unlock();
+        }
+
+        enter(tail);
+
+        // The completion thread notifies while holding the mutex, so the request outlives its last access
+        {
+            std::unique_lock lock(request.mutex);
+            request.completed.wait(lock, [&request] {
+                return request.done;
+            });
+        }
+
+        if (operations) {
+            std::lock_guard lock(operations->mutex);
+            std::erase(operations->inFlight, userData);
+        }
+
+        return request.result;
+    }
+
+    auto Uring::cancel(Operations &operations) -> void {
+        std::lock_guard lock(operations.mutex);
+
+        if (operations.inFlight.empty()) {
+            return;
+        }
+
+        unsigned tail;
+
+        {
+            std::lock_guard submitLock(submitMutex);
+
+            // Only a few operations of a port are in flight at once, far less than the ring holds
+            tail = reserve(static_cast<unsigned>(operations.inFlight.size()));
+
+            for (const std::uint64_t userData : operations.inFlight) {
+                io_uring_sqe &abort = entry(tail);
+                abort.opcode = IORING_OP_ASYNC_CANCEL;
+                abort.fd = -1;
+                abort.addr = userData;
+                abort.user_data = ignoredCompletion;
+            }
+
+            publish(tail);
+        }
+
+        enter(tail);
+    }
+
+    auto Uring::reap() -> void {
+        while (true) {
+            unsigned head = *completionHead;
+            const unsigned tail = std::atomic_ref(*completionTail).load(std::memory_order_acquire);
+
+            if (head == tail) {
+                // Only stop once the completion of the wake up has been handed out
+                if (stopping.load(std::memory_order_relaxed)) {
+                    return;
+                }
+
+                const int result = ioUringEnter(ringFd, 0, 1, IORING_ENTER_GETEVENTS);
+                if (result < 0 && errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+                    return;
+                }
+                continue;
+            }
+
+            for (; head != tail; head++) {
+                const io_uring_cqe &completion = static_cast<io_uring_cqe*>(completionEntries)[head & completionMask];
+
+                if (completion.user_data == ignoredCompletion) {
+                    continue;
+                }
+
+                Request *request = reinterpret_cast<Request*>(completion.user_data);
+                std::lock_guard lock(request->mutex);
+                request->result = completion.res;
+                request->done = true;
+                request->completed.notify_one();
+            }
+
+            std::atomic_ref(*completionHead).store(head, std::memory_order_release);
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,620 @@
+/*
+* Checks of the serial library that need no hardware.
+*
+* The ports are the slave sides of `openpty` pairs, the test plays the device
+* on the master side. Whatever reads sysfs runs against a fake sysfs tree in a
+* temporary directory. The building blocks behind the ports are checked on
+* their own with fake readers and writers.
+*
+* Every failed check is printed, the exit code is 1 if any check failed.
+*
+* Usage: serial_test
+*/
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "serial.h"
+#include "deadline.h"
+#include "delimiter_matcher.h"
+#include "engines.h"
+#include "output_pacing.h"
+#include "priorities.h"
+#include "pushback_buffer.h"
+#include "read_lines.h"
+#include "spsc_ring.h"
+#include "status_code_enum.h"
+#include "transmit_queue.h"
+#include "unix_port_registry.h"
+
+namespace fs = std::filesystem;
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    int failures = 0;
+
+    auto expect(const bool condition, const char* what) -> void {
+        if (!condition) {
+            fprintf(stderr, "FAIL: %s\n", what);
+            failures++;
+        }
+    }
+
+    auto elapsed(const Clock::time_point start) -> long long {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - start).count();
+    }
+
+    auto code(const StatusCodes status) -> int {
+        return static_cast<int>(status);
+    }
+
+    /**
+    * @brief Pseudo terminal pair with a library port on its slave side, closed again at the end of the scope.
+    */
+    struct Loopback {
+        int master{-1};
+        int slave{-1};
+        int handle{0};
+        std::string name;
+
+        explicit Loopback(const Engines engine = Engines::BLOCKING) {
+            char path[128];
+
+            if (openpty(&master, &slave, path, nullptr, nullptr) < 0) {
+                return;
+            }
+
+            name = path;
+            handle = serialOpen(path, 115200, 8, 0, 0, static_cast<int>(engine), 0);
+        }
+
+        ~Loopback() {
+            if (handle > 0) {
+                serialClose(handle);
+            }
+            if (slave >= 0) {
+                ::close(slave);
+            }
+            if (master >= 0) {
+                ::close(master);
+            }
+        }
+
+        auto open() const -> bool {
+            return handle > 0;
+        }
+
+        auto send(const std::string &bytes) const -> bool {
+            return ::write(master, bytes.data(), bytes.size()) == static_cast<ssize_t>(bytes.size());
+        }
+    };
+
+    /**
+    * @brief Temporary directory that is removed with everything in it at the end of the scope.
+    */
+    struct TemporaryTree {
+        fs::path root;
+
+        TemporaryTree() {
+            char pattern[] = "/tmp/serial_test.XXXXXX";
+
+            if (mkdtemp(pattern) != nullptr) {
+                root = pattern;
+            }
+        }
+
+        ~TemporaryTree() {
+            std::error_code error;
+            fs::remove_all(root, error);
+        }
+
+        auto file(const fs::path &path, const std::string &content) const -> void {
+            fs::create_directories((root / path).parent_path());
+            std::ofstream(root / path) << content << '\n';
+        }
+
+        auto link(const fs::path &path, const fs::path &target) const -> void {
+            fs::create_directories((root / path).parent_path());
+            fs::create_directory_symlink(root / target, root / path);
+        }
+    };
+
+    /**
+    * @brief Adds a USB serial adapter to the fake sysfs tree, the way the kernel lays out an FTDI adapter.
+    */
+    auto addUsbPort(const TemporaryTree &sysfs, const std::string &name, const std::string &usbDevice) -> void {
+        const fs::path interface = fs::path("devices/usb1") / usbDevice / (usbDevice + ":1.0");
+
+        sysfs.file(fs::path("devices/usb1") / usbDevice / "idVendor", "0403");
+        sysfs.file(fs::path("devices/usb1") / usbDevice / "idProduct", "6001");
+        sysfs.file(fs::path("devices/usb1") / usbDevice / "serial", "FT" + name);
+        sysfs.file(interface / "bInterfaceNumber", "00");
+        fs::create_directories(sysfs.root / interface / name);
+        fs::create_directories(sysfs.root / "bus/usb-serial/drivers/ftdi_sio");
+        sysfs.link(interface / name / "driver", "bus/usb-serial/drivers/ftdi_sio");
+        sysfs.link(fs::path("class/tty") / name / "device", interface / name);
+    }
+
+    auto testTuneLatency() -> void {
+        Loopback loopback;
+        TemporaryTree sysfs;
+        expect(loopback.open(), "latency: port opens");
+
+        if (!loopback.open()) {
+            return;
+        }
+
+        const fs::path attribute = fs::path("class/tty") / fs::path(loopback.name).filename() / "device/latency_timer";
+        sysfs.file(attribute, "16");
+
+        LatencyTuning tuning{};
+        expect(serialTuneLatency(loopback.handle, 2, 1, const_cast<char*>(sysfs.root.c_str()), &tuning, sizeof(tuning)) == 0, "latency: tuning succeeds");
+        expect(tuning.previousLatencyTimer == 16 && tuning.latencyTimer == 2, "latency: the latency timer is lowered");
+        expect(tuning.lowLatency == -1, "latency: a pty has no serial driver flags");
+
+        int written = 0;
+        std::ifstream(sysfs.root / attribute) >> written;
+        expect(written == 2, "latency: the attribute holds the new timer");
+
+        serialTuneLatency(loopback.handle, 10, 0, const_cast<char*>(sysfs.root.c_str()), &tuning, sizeof(tuning));
+        expect(tuning.latencyTimer == 2, "latency: the latency timer is never raised");
+    }
+
+    auto testDelimiterMatcher() -> void {
+        DelimiterMatcher matcher;
+        matcher.compile("abab", 4);
+
+        expect(matcher.size() == 4, "matcher: size is the delimiter length");
+        expect(matcher.feed("xxabaababy", 10) == 9, "matcher: finds an overlapping delimiter");
+
+        // A delimiter split across two chunks completes in the second one
+        expect(matcher.feed("xab", 3) == DelimiterMatcher::npos, "matcher: an unfinished delimiter is no match");
+        expect(matcher.feed("ab", 2) == 2, "matcher: a delimiter completes across chunks");
+
+        expect(matcher.feed("aba", 3) == DelimiterMatcher::npos, "matcher: a prefix is no match");
+        matcher.reset();
+        expect(matcher.feed("b", 1) == DelimiterMatcher::npos, "matcher: reset forgets the prefix");
+
+        matcher.compile("\n", 1);
+        expect(matcher.feed("line\n", 5) == 5, "matcher: single byte delimiter");
+    }
+
+    auto testSpscRing() -> void {
+        SpscRing ring(100);
+        expect(ring.size() == 128, "ring: the capacity is rounded up to a power of two");
+
+        std::string sent;
+        std::string received;
+
+        // Enough rounds to wrap around several times
+        for (int round = 0; round < 20; round++) {
+            std::string chunk(50, static_cast<char>('a' + round));
+
+            for (std::size_t offset = 0; offset < chunk.size(); ) {
+                const std::span<char> room = ring.prepare();
+                const std::size_t count = std::min(room.size(), chunk.size() - offset);
+
+                if (count == 0) {
+                    break;
+                }
+
+                memcpy(room.data(), chunk.data() + offset, count);
+                ring.commit(count);
+                offset += count;
+            }
+
+            sent += chunk;
+
+            char buffer[64];
+            while (const std::size_t count = ring.read(buffer, sizeof(buffer))) {
+                received.append(buffer, count);
+            }
+        }
+
+        expect(ring.readable() == 0, "ring: everything committed was read");
+        expect(sent == received, "ring: bytes come out in order across the wrap around");
+    }
+
+    auto testDeadline() -> void {
+        expect(Deadline::forRead(0, 0, 0).expired(), "deadline: a read without timeout is expired right away");
+        expect(Deadline::forWrite(0, 0, 0).remaining() == -1, "deadline: a write without timeout is unbounded");
+
+        const int remaining = Deadline::forRead(50, 0, 0).remaining();
+        expect(remaining > 0 && remaining <= 50, "deadline: the timeout bounds the remaining time");
+        expect(Deadline::forRead(10, 2, 20).remaining() > 10, "deadline: the multiplier adds time per byte");
+
+        Deadline deadline = Deadline::forRead(20, 0, 0);
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        expect(deadline.expired(), "deadline: expires once the timeout has passed");
+
+        // Progress restarts the gap timer, but never beyond the total
+        Deadline gap = Deadline::forRead(30, 10, 10);
+        gap.progress();
+        expect(gap.remaining() <= 30, "deadline: progress bounds the gap to the timeout");
+    }
+
+    auto testWriteDeadline() -> void {
+        Loopback loopback;
+        expect(loopback.open(), "write: port opens");
+
+        if (!loopback.open()) {
+            return;
+        }
+
+        // Nobody reads the master side, so the pty fills up and the write has to give up at its deadline
+        const std::vector<char> data(1024 * 1024, 'w');
+        const auto start = Clock::now();
+        const int written = serialWrite(loopback.handle, const_cast<char*>(data.data()), static_cast<int>(data.size()), 200, 0);
+        const long long took = elapsed(start);
+
+        expect(written >= 0 && written < static_cast<int>(data.size()), "write: a stalled write returns what it wrote");
+        expect(took >= 150 && took < 1000, "write: a stalled write returns at its deadline");
+    }
+
+    auto testCanonicalLines() -> void {
+        Loopback loopback;
+        expect(loopback.open(), "canonical: port opens");
+
+        if (!loopback.open()) {
+            return;
+        }
+
+        char buffer[64];
+
+        // The slave side shares the line discipline settings with the port
+        const auto readLines = [&] {
+            for (int i = 0; i < 5; i++) {
+                loopback.send("abc;");
+                const int result = serialReadUntil(loopback.handle, buffer, sizeof(buffer), 500, 0, const_cast<char*>(";"));
+                expect(result == 4 && memcmp(buffer, "abc;", 4) == 0, "canonical: every line arrives whole");
+            }
+
+            termios tty{};
+            tcgetattr(loopback.slave, &tty);
+            return (tty.c_lflag & ICANON) != 0;
+        };
+
+        expect(!readLines(), "canonical: the tty stays raw unless the port allows canonical mode");
+
+        // Repeated reads with the same delimiter move the tty into canonical mode once it is allowed
+        expect(serialSetCanonicalLines(loopback.handle, 1) == 0, "canonical: canonical mode is allowed");
+        expect(readLines(), "canonical: repeated delimiters move the tty into canonical mode");
+
+        // A line longer than the buffer arrives in pieces and nothing of it gets lost
+        loopback.send("0123456789ABCDEFGHIJ;");
+        const int first = serialReadUntil(loopback.handle, buffer, 8, 500, 0, const_cast<char*>(";"));
+        const int second = serialReadUntil(loopback.handle, buffer + 8, sizeof(buffer) - 8, 500, 0, const_cast<char*>(";"));
+        expect(first == 8 && second == 13, "canonical: a long line is split at the buffer size");
+        expect(memcmp(buffer, "0123456789ABCDEFGHIJ;", 21) == 0, "canonical: a long line keeps every byte");
+
+        expect(readLines(), "canonical: the tty returns to canonical mode for short lines");
+        expect(serialSetCanonicalLines(loopback.handle, 0) == 0, "canonical: canonical mode is turned off");
+
+        termios tty{};
+        tcgetattr(loopback.slave, &tty);
+        expect((tty.c_lflag & ICANON) == 0, "canonical: turning it off switches the tty back to raw mode");
+    }
+
+    auto testReadLines() -> void {
+        PushbackBuffer pushback;
+        DelimiterMatcher matcher;
+        matcher.compile("\n", 1);
+
+        char buffer[64];
+        std::uint32_t offsets[8];
+        std::size_t consumed = 0;
+        int reads = 0;
+
+        const int lines = readLineBatch(pushback, buffer, sizeof(buffer), offsets, 4, matcher, [&](char* destination, const std::size_t size, bool) {
+            if (reads++ > 0) {
+                return 0;
+            }
+            const std::string received = "a\nbb\nccc";
+            memcpy(destination, received.data(), std::min(size, received.size()));
+            return static_cast<int>(received.size());
+        }, consumed);
+
+        expect(lines == 2, "lines: a batch takes every complete line");
+        expect(offsets[0] == 0 && offsets[1] == 1 && offsets[2] == 2 && offsets[3] == 4, "lines: offsets exclude the delimiter");
+        expect(consumed == 5, "lines: consumed counts the delimiters");
+        expect(pushback.size() == 3, "lines: the unfinished line is kept for the next read");
+
+        // The same over a port
+        Loopback loopback;
+        expect(loopback.open(), "lines: port opens");
+
+        if (loopback.open()) {
+            loopback.send("one\ntwo\nthr");
+
+            std::uint32_t portOffsets[8];
+            const int portLines = serialReadLines(loopback.handle, buffer, sizeof(buffer), portOffsets, 4, 500, 0, const_cast<char*>("\n"));
+            expect(portLines == 2, "lines: a port hands out the complete lines");
+            expect(portLines == 2 && memcmp(buffer + portOffsets[2], "two", 3) == 0, "lines: a port hands out the line bytes");
+
+            loopback.send("ee\n");
+            const int rest = serialReadLines(loopback.handle, buffer, sizeof(buffer), portOffsets, 4, 500, 0, const_cast<char*>("\n"));
+            expect(rest == 1 && memcmp(buffer, "three", 5) == 0, "lines: the unfinished line completes with the next read");
+        }
+    }
+
+    auto testEnumeratePorts() -> void {
+        TemporaryTree sysfs;
+        expect(!sysfs.root.empty(), "ports: temporary tree is created");
+
+        addUsbPort(sysfs, "ttyUSB7", "1-1");
+
+        // An on-board UART without a USB ancestor and a virtual terminal without a device
+        fs::create_directories(sysfs.root / "devices/platform/uart/tty/ttyAMA0");
+        fs::create_directories(sysfs.root / "bus/amba/drivers/uart-pl011");
+        sysfs.link("devices/platform/uart/tty/ttyAMA0/driver", "bus/amba/drivers/uart-pl011");
+        sysfs.link("class/tty/ttyAMA0/device", "devices/platform/uart/tty/ttyAMA0");
+        fs::create_directories(sysfs.root / "class/tty/tty0");
+
+        PortInfo infos[4];
+        const int count = serialEnumeratePorts(infos, sizeof(infos), const_cast<char*>(sysfs.root.c_str()));
+        expect(count == 2, "ports: ttys without a device are left out");
+
+        if (count == 2) {
+            expect(strcmp(infos[0].path, "/dev/ttyAMA0") == 0 && infos[0].vendorId == 0, "ports: on-board UART is listed without vendor");
+            expect(strcmp(infos[0].driver, "uart-pl011") == 0, "ports: on-board UART has its driver");
+            expect(strcmp(infos[1].path, "/dev/ttyUSB7") == 0, "ports: the ports are sorted by path");
+            expect(infos[1].vendorId == 0x0403 && infos[1].productId == 0x6001, "ports: USB ids are read");
+            expect(strcmp(infos[1].serialNumber, "FTttyUSB7") == 0, "ports: USB serial number is read");
+            expect(infos[1].interfaceNumber == 0 && strcmp(infos[1].driver, "ftdi_sio") == 0, "ports: USB interface and driver are read");
+        }
+
+        expect(serialEnumeratePorts(infos, 0, const_cast<char*>(sysfs.root.c_str())) == 2, "ports: a buffer size of 0 only counts");
+    }
+
+    auto testPortRegistry() -> void {
+        TemporaryTree sysfs;
+        TemporaryTree dev;
+        expect(!sysfs.root.empty() && !dev.root.empty(), "registry: temporary trees are created");
+
+        addUsbPort(sysfs, "ttyUSB7", "1-1");
+
+        // The registry follows device nodes appearing and disappearing
+        UnixSystem::PortRegistry registry(sysfs.root, dev.root);
+        expect(registry.watching(), "registry: watches the device directory");
+        expect(registry.ports()->size() == 1, "registry: the first scan finds the ports");
+
+        addUsbPort(sysfs, "ttyUSB8", "1-2");
+
+        std::uint64_t generation = registry.generation();
+        std::ofstream(dev.root / "ttyUSB8").close();
+        generation = registry.waitForChange(generation, 2000);
+        expect(registry.ports()->size() == 2, "registry: a new device node adds its port");
+
+        std::ofstream(dev.root / "notes").close();
+        expect(registry.waitForChange(generation, 100) == generation, "registry: other files leave the list alone");
+
+        fs::remove(dev.root / "ttyUSB8");
+        registry.waitForChange(generation, 2000);
+        expect(registry.ports()->size() == 1, "registry: a removed device node drops its port");
+    }
+
+    auto testWriteQueueCoalescing() -> void {
+        // Small frames that arrive together are coalesced into a single write
+        std::atomic<int> writes{0};
+
+        TransmitQueue queue(
+            [&](const char*, const int size) {
+                writes++;
+                return size;
+            },
+            [] { return 0; },
+            64 * 1024,
+            512,
+            std::chrono::microseconds(100000),
+            1024
+        );
+
+        for (int i = 0; i < 10; i++) {
+            queue.push("0123456789", 10, Priorities::BULK, 0);
+        }
+
+        expect(queue.flush(2000) == 0, "write queue: flush of coalesced frames");
+
+        const WriteQueueStatus status = queue.snapshot();
+        expect(writes == 1 && status.writes == 1, "write queue: frames are coalesced into one write");
+        expect(status.bytesWritten == 100, "write queue: coalesced bytes are all written");
+    }
+
+    auto testUrgentPriority() -> void {
+        // Urgent bytes overtake queued bulk bytes at the next slice boundary
+        std::mutex mutex;
+        std::condition_variable released;
+        bool open = false;
+        std::string output;
+
+        TransmitQueue queue(
+            [&](const char* data, const int size) {
+                std::unique_lock lock(mutex);
+                released.wait(lock, [&] { return open; });
+                output.append(data, static_cast<std::size_t>(size));
+                return size;
+            },
+            [] { return 0; },
+            64 * 1024,
+            512,
+            std::chrono::microseconds(1000),
+            256
+        );
+
+        const std::string bulk(4096, 'b');
+        expect(queue.push(bulk.data(), bulk.size(), Priorities::BULK, 0) == 4096, "write queue: bulk bytes are queued");
+
+        // The writer is stuck in the first slice when the urgent frame arrives
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        expect(queue.push("URGENT", 6, Priorities::URGENT, 0) == 6, "write queue: urgent bytes are queued");
+
+        {
+            std::lock_guard lock(mutex);
+            open = true;
+        }
+        released.notify_all();
+
+        expect(queue.flush(2000) == 0, "write queue: flush waits for every byte");
+
+        std::lock_guard lock(mutex);
+        const std::size_t position = output.find("URGENT");
+        expect(output.size() == 4102, "write queue: every byte is written once");
+        expect(position != std::string::npos && position <= 512, "write queue: urgent bytes wait behind at most two slices");
+    }
+
+    /**
+    * @brief Output queue of a fake line that sends `baudrate / 10` bytes per second.
+    */
+    struct FakeLine {
+        int baudrate;
+        Clock::time_point start{Clock::now()};
+        std::size_t queued{0};
+        int deepest{0};
+
+        auto backlog() -> int {
+            const double sent = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count()) * baudrate / 10e6;
+            return static_cast<int>(std::max(0.0, static_cast<double>(queued) - sent));
+        }
+
+        auto write(const std::size_t size) -> int {
+            queued += size;
+            deepest = std::max(deepest, backlog());
+            return static_cast<int>(size);
+        }
+    };
+
+
+    auto testPacedWrite() -> void {
+        const std::vector<char> data(2048, 'p');
+
+        // At 115200 baud the line sends 11.52 bytes per millisecond
+        FakeLine line{115200};
+        const int written = pacedWrite(data.data(), data.size(), 256, line.baudrate,
+            [&] { return line.backlog(); },
+            [&](const char*, const std::size_t size) { return line.write(size); },
+            Deadline::forWrite(0, 0, 0));
+
+        expect(written == 2048, "pacing: every byte is written");
+        expect(line.deepest <= 256, "pacing: the output queue stays within the limit");
+        expect(elapsed(line.start) >= 100, "pacing: the bytes are handed out as the line sends them");
+
+        // A deadline ends the write early
+        FakeLine slow{9600};
+        const int partial = pacedWrite(data.data(), data.size(), 256, slow.baudrate,
+            [&] { return slow.backlog(); },
+            [&](const char*, const std::size_t size) { return slow.write(size); },
+            Deadline::forWrite(30, 0, 0));
+
+        expect(partial > 0 && partial < 2048, "pacing: the deadline ends a paced write");
+        expect(elapsed(slow.start) < 500, "pacing: a paced write returns at its deadline");
+
+        // Without the depth of the output queue the bytes go out unpaced
+        int calls = 0;
+        const int unpaced = pacedWrite(data.data(), data.size(), 256, 115200,
+            [] { return -1; },
+            [&](const char*, const std::size_t size) {
+                calls++;
+                return static_cast<int>(size);
+            },
+            Deadline::forWrite(0, 0, 0));
+
+        expect(unpaced == 2048 && calls == 1, "pacing: an unknown backlog writes everything at once");
+    }
+
+    auto testDrain() -> void {
+        Loopback loopback;
+        expect(loopback.open(), "drain: port opens");
+
+        if (!loopback.open()) {
+            return;
+        }
+
+        // The write queue holds small writes back for half a second before it coalesces them
+        expect(serialConfigureWriteQueue(loopback.handle, 4096, 4096, 500000, 256) == 0, "drain: the write queue is configured");
+
+        char data[100] = {};
+        expect(serialEnqueueWrite(loopback.handle, data, sizeof(data), 0, 0) == 100, "drain: bytes are queued");
+
+        auto start = Clock::now();
+        expect(serialDrain(loopback.handle, 0) == 100, "drain: a timeout of 0 reports the pending bytes");
+        expect(elapsed(start) < 50, "drain: a timeout of 0 only checks once");
+
+        start = Clock::now();
+        expect(serialDrain(loopback.handle, 50) == 100, "drain: a short timeout expires first");
+        expect(elapsed(start) >= 40, "drain: a short timeout waits");
+
+        expect(serialDrain(loopback.handle, -1) == 0, "drain: a negative timeout waits until everything is sent");
+    }
+
+    auto testCancel() -> void {
+        for (const Engines engine : {Engines::BLOCKING, Engines::REACTOR, Engines::IO_URING, Engines::BUFFERED}) {
+            Loopback loopback(engine);
+
+            // io_uring may be missing or forbidden, the other engines always open
+            if (!loopback.open()) {
+                expect(engine == Engines::IO_URING, "cancel: port opens");
+                continue;
+            }
+
+            char buffer[16];
+            int result = 0;
+            const auto start = Clock::now();
+
+            std::thread reader([&] {
+                result = serialRead(loopback.handle, buffer, sizeof(buffer), 5000, 0);
+            });
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            expect(serialCancel(loopback.handle) == 0, "cancel: cancel succeeds");
+            reader.join();
+
+            expect(result == code(StatusCodes::CANCELLED_ERROR), "cancel: a waiting read returns cancelled");
+            expect(elapsed(start) < 1000, "cancel: a waiting read ends right away");
+
+            // The port keeps working after a cancel
+            loopback.send("ok");
+            expect(serialRead(loopback.handle, buffer, 2, 1000, 0) == 2, "cancel: the port reads again afterwards");
+        }
+    }
+}
+
+auto main() -> int {
+    testTuneLatency();
+    testDelimiterMatcher();
+    testSpscRing();
+    testDeadline();
+    testWriteDeadline();
+    testCanonicalLines();
+    testReadLines();
+    testEnumeratePorts();
+    testPortRegistry();
+    testWriteQueueCoalescing();
+    testUrgentPriority();
+    testPacedWrite();
+    testDrain();
+    testCancel();
+
+    if (failures > 0) {
+        fprintf(stderr, "%d checks failed\n", failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}